@@ -122,6 +122,22 @@ constexpr auto lerpc(T from, T2 to, T3 weight) {
 	return from + (to - from) * std::clamp<double>(weight, 0.0, 1.0);
 }
 
+/**
+* @brief Linearly interpolates between the angles @b from and @b to in degrees, the short way around the circle.
+* @details Interpolating from 359 to 1 degrees passes 360 degrees instead of turning back through 180 degrees.
+* The result isn't wrapped, so it can be outside of 0 and 360 degrees.
+*/
+template<class T, class T2, class T3, enable_if_arithmetic<T> = true, enable_if_arithmetic<T2> = true, enable_if_arithmetic<T3> = true>
+constexpr auto lerp_angle_degrees(T from, T2 to, T3 weight) {
+	// Wraps the difference into [-180, 180) degrees, rounding the amount of turns down also for negative differences.
+	const auto shifted_turns = (to - from + 180.0) / 360.0;
+	int64_t turns = static_cast<int64_t>(shifted_turns);
+	if (turns > shifted_turns)
+		turns--;
+
+	return from + ((to - from) - turns * 360.0) * weight;
+}
+
 }
 
 }
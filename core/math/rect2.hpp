@@ -387,6 +387,24 @@ struct Rect2 {
 		return new_rect;
 	}
 
+	/**
+	* @brief Returns the area where this rectangle and the given Rect2 overlap, or an empty Rect2 if they don't intersect.
+	*/
+	[[nodiscard]] constexpr Rect2 intersection(const Rect2 &right) const {
+		if (!intersects(right))
+			return Rect2();
+
+		Rect2 new_rect;
+
+		new_rect.x = std::max(right.x, x);
+		new_rect.y = std::max(right.y, y);
+
+		new_rect.w = std::min(right.x + right.w, x + w) - new_rect.x;
+		new_rect.h = std::min(right.y + right.h, y + h) - new_rect.y;
+
+		return new_rect;
+	}
+
 	/**
 	* @brief Returns this rect with its components set to absolute values of themselfs.
 	*/
@@ -61,6 +61,12 @@ struct Transform2D {
 
 	constexpr Transform2D operator*(const Transform2D &right) const;
 
+	/**
+	* @brief Returns the transform linearly interpolated between this transform and @param to by @param weight.
+	* @details The rotation turns the short way around, see @b Math::lerp_angle_degrees.
+	*/
+	[[nodiscard]] constexpr Transform2D interpolate_with(const Transform2D &to, const real weight) const;
+
 	#ifdef TOOF_PHYSICS_ENABLED
 	[[nodiscard]] b2Transform to_b2_transform() const;
 	#endif
@@ -172,6 +178,15 @@ constexpr Transform2D Transform2D::operator*(const Transform2D &right) const {
 	return Transform2D(rotation + right.rotation, origin + right.origin, scale * right.scale);
 }
 
+constexpr Transform2D Transform2D::interpolate_with(const Transform2D &to, const real weight) const {
+	Vector2f new_origin = origin;
+	Vector2f new_scale = scale;
+	new_origin.lerp_to(to.origin, weight);
+	new_scale.lerp_to(to.scale, weight);
+
+	return Transform2D(Angle::from_degrees(Math::lerp_angle_degrees(rotation.get_angle_degrees(), to.rotation.get_angle_degrees(), weight)), new_origin, new_scale);
+}
+
 constexpr void Transform2D::operator=(const Transform2D &right) {
 	origin = right.origin;
 	rotation = right.rotation;
@@ -0,0 +1,227 @@
+/*  This file is part of the Toof Engine. */
+/** @file call_queue.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Toof {
+
+/**
+* @brief A queue of deferred calls that can be pushed from any thread and is flushed from a single thread.
+* @details Calls are stored in a ring buffer that is allocated once and reused, callables that fit in @b CALL_STORAGE_SIZE bytes
+* (like a lambda capturing a few pointers) are stored inline, so pushing and flushing doesn't allocate.
+* Pushing is lock-free. When the ring buffer is full, or the callable is too large, the call is stored in a locked overflow list instead.
+* Overflow calls remember the ring buffer position they were pushed at and are called in between the ring buffer calls, so the calls
+* of one thread are always made in the order they were pushed in.
+*/
+class CallQueue {
+public:
+	static constexpr natural CALL_STORAGE_SIZE = 48;
+private:
+	struct Call {
+		std::atomic<uint64_t> sequence;
+		void (*invoke)(void *storage);
+		void (*destroy)(void *storage);
+		alignas(std::max_align_t) unsigned char storage[CALL_STORAGE_SIZE];
+	};
+
+	std::unique_ptr<Call[]> calls;
+	uint64_t capacity_mask;
+	std::atomic<uint64_t> enqueue_position;
+	uint64_t dequeue_position;
+
+	struct OverflowCall {
+		// The ring buffer position that was next when the call was pushed, the call is made before the call at that position.
+		uint64_t position;
+		std::function<void()> function;
+	};
+
+	std::mutex overflow_mutex;
+	std::vector<OverflowCall> overflow_calls;
+	std::vector<OverflowCall> flushing_overflow_calls;
+
+	template<class F>
+	static void _invoke_call(void *storage) {
+		F *function = std::launder(reinterpret_cast<F*>(storage));
+		(*function)();
+		function->~F();
+	}
+
+	template<class F>
+	static void _destroy_call(void *storage) {
+		std::launder(reinterpret_cast<F*>(storage))->~F();
+	}
+
+	// Claims the next free call in the ring buffer, returns nullptr if it is full.
+	Call *_claim_call(uint64_t &position) {
+		position = enqueue_position.load(std::memory_order_relaxed);
+
+		while (true) {
+			Call &call = calls[position & capacity_mask];
+			const uint64_t sequence = call.sequence.load(std::memory_order_acquire);
+
+			if (sequence == position) {
+				if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					return &call;
+			} else if (sequence < position)
+				return nullptr;
+			else
+				position = enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class F>
+	void _push_overflow(F &&function) {
+		std::lock_guard<std::mutex> lock(overflow_mutex);
+
+		// Read while holding the lock, so the positions in the overflow list never decrease.
+		overflow_calls.push_back({enqueue_position.load(std::memory_order_acquire), std::function<void()>(std::forward<F>(function))});
+	}
+
+	// Moves the overflow calls made before the ring buffer position @b end to the calls being flushed.
+	void _take_overflow_calls(const uint64_t end) {
+		std::lock_guard<std::mutex> lock(overflow_mutex);
+
+		natural count = 0;
+		while (count < overflow_calls.size() && overflow_calls[count].position <= end)
+			count++;
+
+		for (natural i = 0; i < count; i++)
+			flushing_overflow_calls.push_back(std::move(overflow_calls[i]));
+		overflow_calls.erase(overflow_calls.begin(), overflow_calls.begin() + count);
+	}
+public:
+	/**
+	* @brief Creates a queue that holds @b capacity calls without allocating, rounded up to a power of two.
+	*/
+	explicit CallQueue(const natural capacity = 1024): calls(), capacity_mask(0), enqueue_position(0), dequeue_position(0) {
+		uint64_t rounded_capacity = 1;
+		while (rounded_capacity < capacity)
+			rounded_capacity <<= 1;
+
+		calls = std::make_unique<Call[]>(rounded_capacity);
+		capacity_mask = rounded_capacity - 1;
+
+		for (uint64_t i = 0; i < rounded_capacity; i++)
+			calls[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Destroys the calls that haven't been flushed without calling them.
+	*/
+	~CallQueue() {
+		const uint64_t end = enqueue_position.load(std::memory_order_acquire);
+		for (; dequeue_position < end; dequeue_position++) {
+			Call &call = calls[dequeue_position & capacity_mask];
+			call.destroy(call.storage);
+		}
+	}
+
+	CallQueue(const CallQueue&) = delete;
+	CallQueue &operator=(const CallQueue&) = delete;
+
+	/**
+	* @brief Queues @b function to be called on the next flush. Safe to call from any thread.
+	*/
+	template<class F>
+	void push(F &&function) {
+		using Function = std::decay_t<F>;
+
+		if constexpr (sizeof(Function) > CALL_STORAGE_SIZE || alignof(Function) > alignof(std::max_align_t))
+			_push_overflow(std::forward<F>(function));
+		else {
+			uint64_t position;
+			Call *call = _claim_call(position);
+			if (!call) {
+				_push_overflow(std::forward<F>(function));
+				return;
+			}
+
+			new (call->storage) Function(std::forward<F>(function));
+			call->invoke = &_invoke_call<Function>;
+			call->destroy = &_destroy_call<Function>;
+			call->sequence.store(position + 1, std::memory_order_release);
+		}
+	}
+
+	/**
+	* @brief Queues a call of @b method on @b object with @b args.
+	*/
+	template<class T, class... Args, class... CallArgs>
+	void push(T *object, void (T::*method)(Args...), CallArgs&&... args) {
+		push([object, method, args...]() {
+			(object->*method)(args...);
+		});
+	}
+
+	/**
+	* @brief Calls and removes every call that was queued before the flush started. Must only be called from one thread at a time.
+	* @details Calls queued while flushing are called on the next flush.
+	*/
+	void flush() {
+		const uint64_t end = enqueue_position.load(std::memory_order_acquire);
+		_take_overflow_calls(end);
+		natural overflow_index = 0;
+
+		for (; dequeue_position < end; dequeue_position++) {
+			for (; overflow_index < flushing_overflow_calls.size() && flushing_overflow_calls[overflow_index].position <= dequeue_position; overflow_index++)
+				flushing_overflow_calls[overflow_index].function();
+
+			Call &call = calls[dequeue_position & capacity_mask];
+
+			// The call is claimed, but the pushing thread may still be constructing it.
+			while (call.sequence.load(std::memory_order_acquire) != dequeue_position + 1)
+				std::this_thread::yield();
+
+			call.invoke(call.storage);
+			call.sequence.store(dequeue_position + capacity_mask + 1, std::memory_order_release);
+		}
+
+		for (; overflow_index < flushing_overflow_calls.size(); overflow_index++)
+			flushing_overflow_calls[overflow_index].function();
+		flushing_overflow_calls.clear();
+	}
+};
+
+}
@@ -0,0 +1,151 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <core/os/profiler.hpp>
+
+#include <chrono>
+#include <fstream>
+
+using namespace Toof;
+
+detail::ProfileBuffer::ProfileBuffer(const natural thread_index): zones(std::make_unique<std::array<Zone, CAPACITY>>()),
+    zone_count(0),
+    cleared_count(0),
+    thread_index(thread_index) {
+}
+
+void detail::ProfileBuffer::record(const char *name, const int64_t start, const int64_t end) {
+	const uint64_t index = zone_count.load(std::memory_order_relaxed);
+	Zone &zone = (*zones)[index % CAPACITY];
+
+	// The slot is marked as being written first, so the exporter skips it instead of reading half a zone.
+	zone.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	zone.name.store(name, std::memory_order_relaxed);
+	zone.start.store(start, std::memory_order_relaxed);
+	zone.end.store(end, std::memory_order_relaxed);
+
+	zone.sequence.store(index + 1, std::memory_order_release);
+	zone_count.store(index + 1, std::memory_order_release);
+}
+
+void detail::ProfileBuffer::clear() {
+	cleared_count.store(zone_count.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+Profiler &Profiler::get_singleton() {
+	static Profiler profiler;
+	return profiler;
+}
+
+int64_t Profiler::get_time_now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+detail::ProfileBuffer &Profiler::_get_thread_buffer() {
+	// Shared with the profiler, so the zones of a thread can still be exported after the thread exited.
+	thread_local std::shared_ptr<detail::ProfileBuffer> thread_buffer;
+
+	if (!thread_buffer) {
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		thread_buffer = std::make_shared<detail::ProfileBuffer>(buffers.size());
+		buffers.push_back(thread_buffer);
+	}
+
+	return *thread_buffer;
+}
+
+void Profiler::record_zone(const char *name, const int64_t start, const int64_t end) {
+	_get_thread_buffer().record(name, start, end);
+}
+
+static void write_json_string(std::ostream &stream, const char *string) {
+	stream << '"';
+
+	for (; *string; string++) {
+		if (*string == '"' || *string == '\\')
+			stream << '\\';
+		stream << *string;
+	}
+
+	stream << '"';
+}
+
+// Written with integers, printing the time stamps as doubles would round them to a few significant digits.
+static void write_microseconds(std::ostream &stream, const int64_t nanoseconds) {
+	const int64_t fraction = nanoseconds % 1000;
+
+	stream << nanoseconds / 1000 << '.';
+	stream << static_cast<char>('0' + fraction / 100) << static_cast<char>('0' + fraction / 10 % 10) << static_cast<char>('0' + fraction % 10);
+}
+
+void Profiler::write_chrome_trace(std::ostream &stream) const {
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	bool first = true;
+
+	stream << "{\"traceEvents\":[";
+
+	for (const std::shared_ptr<detail::ProfileBuffer> &buffer: buffers)
+		buffer->for_each([&stream, &first, &buffer](const char *name, const int64_t start, const int64_t end) {
+			if (!first)
+				stream << ',';
+			first = false;
+
+			// Complete events, with the time stamp and duration in microseconds.
+			stream << "{\"name\":";
+			write_json_string(stream, name);
+			stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->get_thread_index();
+			stream << ",\"ts\":";
+			write_microseconds(stream, start);
+			stream << ",\"dur\":";
+			write_microseconds(stream, end - start);
+			stream << '}';
+		});
+
+	stream << "],\"displayTimeUnit\":\"ms\"}";
+}
+
+bool Profiler::save_chrome_trace(const std::filesystem::path &path) const {
+	std::ofstream file = std::ofstream(path);
+	if (!file.is_open())
+		return false;
+
+	write_chrome_trace(file);
+	return true;
+}
+
+void Profiler::clear() {
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+
+	for (const std::shared_ptr<detail::ProfileBuffer> &buffer: buffers)
+		buffer->clear();
+}
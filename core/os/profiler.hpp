@@ -0,0 +1,186 @@
+/*  This file is part of the Toof Engine. */
+/** @file profiler.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#define TOOF_DETAIL_PROFILE_CONCAT_INNER(a, b) a##b
+#define TOOF_DETAIL_PROFILE_CONCAT(a, b) TOOF_DETAIL_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef TOOF_PROFILING_ENABLED
+/**
+* @brief Records the time from this line until the end of the scope as a zone named @b name, which must be a string literal.
+* @details Compiles to nothing unless the engine is built with the profiling option.
+*/
+#define TOOF_PROFILE_ZONE(name) const Toof::ProfileZone TOOF_DETAIL_PROFILE_CONCAT(__toof_profile_zone_, __LINE__)(name)
+#else
+#define TOOF_PROFILE_ZONE(name)
+#endif
+
+/**
+* @brief Records the time until the end of the function as a zone named after the function.
+*/
+#define TOOF_PROFILE_FUNCTION() TOOF_PROFILE_ZONE(__func__)
+
+namespace Toof {
+
+namespace detail {
+
+/**
+* @brief A ring buffer of the zones recorded by one thread.
+* @details Only the owning thread writes to the buffer, so recording a zone doesn't lock. Each slot has a sequence number
+* that is written last, the exporter compares it before and after reading a slot to skip slots that were overwritten meanwhile.
+*/
+class ProfileBuffer {
+public:
+	static constexpr natural CAPACITY = 1 << 16;
+
+	struct Zone {
+		std::atomic<uint64_t> sequence;
+		std::atomic<const char*> name;
+		std::atomic<int64_t> start;
+		std::atomic<int64_t> end;
+	};
+private:
+	std::unique_ptr<std::array<Zone, CAPACITY>> zones;
+	std::atomic<uint64_t> zone_count;
+	std::atomic<uint64_t> cleared_count;
+	natural thread_index;
+public:
+	explicit ProfileBuffer(const natural thread_index);
+
+	void record(const char *name, const int64_t start, const int64_t end);
+
+	/**
+	* @brief Calls @b function with the name, start and end of every zone still inside the buffer, oldest first.
+	*/
+	template<class F>
+	void for_each(const F &function) const {
+		const uint64_t count = zone_count.load(std::memory_order_acquire);
+		const uint64_t first = std::max(count > CAPACITY ? count - CAPACITY : 0, cleared_count.load(std::memory_order_acquire));
+
+		for (uint64_t i = first; i < count; i++) {
+			const Zone &zone = (*zones)[i % CAPACITY];
+			const uint64_t sequence = zone.sequence.load(std::memory_order_acquire);
+			const char *name = zone.name.load(std::memory_order_relaxed);
+			const int64_t start = zone.start.load(std::memory_order_relaxed);
+			const int64_t end = zone.end.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence == i + 1 && zone.sequence.load(std::memory_order_relaxed) == sequence)
+				function(name, start, end);
+		}
+	}
+
+	/**
+	* @brief Skips the zones recorded so far when exporting. Only the owning thread writes to the buffer, so it isn't emptied.
+	*/
+	void clear();
+
+	constexpr natural get_thread_index() const {
+		return thread_index;
+	}
+};
+
+}
+
+/**
+* @brief Collects the zones recorded by @b TOOF_PROFILE_ZONE on every thread.
+* @details Every thread records into its own ring buffer, which keeps the last @b ProfileBuffer::CAPACITY zones.
+* The zones can be exported in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto.
+*/
+class Profiler {
+	std::vector<std::shared_ptr<detail::ProfileBuffer>> buffers;
+	mutable std::mutex buffers_mutex;
+
+	Profiler() = default;
+
+	detail::ProfileBuffer &_get_thread_buffer();
+public:
+	static Profiler &get_singleton();
+
+	/**
+	* @brief Returns the current time in nanoseconds, as used by the recorded zones.
+	*/
+	static int64_t get_time_now();
+
+	/**
+	* @brief Records a zone on the calling thread. @b name must stay valid until the zones are exported or cleared.
+	*/
+	void record_zone(const char *name, const int64_t start, const int64_t end);
+
+	/**
+	* @brief Writes every recorded zone as Chrome trace event JSON.
+	*/
+	void write_chrome_trace(std::ostream &stream) const;
+
+	/**
+	* @brief Writes every recorded zone as Chrome trace event JSON to the file at @b path.
+	* @returns @b false if the file couldn't be opened.
+	*/
+	bool save_chrome_trace(const std::filesystem::path &path) const;
+
+	/**
+	* @brief Removes the recorded zones of every thread.
+	*/
+	void clear();
+};
+
+/**
+* @brief Records the lifetime of the object as a zone, see @b TOOF_PROFILE_ZONE.
+*/
+class ProfileZone {
+	const char *name;
+	int64_t start;
+public:
+	explicit ProfileZone(const char *name): name(name), start(Profiler::get_time_now()) {
+	}
+
+	~ProfileZone() {
+		Profiler::get_singleton().record_zone(name, start, Profiler::get_time_now());
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone &operator=(const ProfileZone&) = delete;
+};
+
+}
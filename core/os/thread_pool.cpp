@@ -0,0 +1,147 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <core/os/thread_pool.hpp>
+
+using namespace Toof;
+
+// Set while the thread runs a job, also on the thread calling parallel_for.
+static thread_local bool running_job = false;
+
+ThreadPool::ThreadPool(const natural thread_count): threads(),
+    job_queues(),
+    queued_jobs(0),
+    unfinished_jobs(0),
+    running(true) {
+	// The last queue belongs to the thread calling parallel_for.
+	for (natural i = 0; i <= thread_count; i++)
+		job_queues.push_back(std::make_unique<JobQueue>());
+
+	for (natural i = 0; i < thread_count; i++)
+		threads.emplace_back(&ThreadPool::_worker_loop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		running = false;
+	}
+	wake_condition.notify_all();
+
+	for (std::thread &thread: threads)
+		thread.join();
+}
+
+bool ThreadPool::_pop_job(const natural queue_index, Job &job) {
+	{
+		JobQueue &own_queue = *job_queues[queue_index];
+		std::lock_guard<std::mutex> lock(own_queue.mutex);
+
+		if (!own_queue.jobs.empty()) {
+			job = own_queue.jobs.back();
+			own_queue.jobs.pop_back();
+			queued_jobs--;
+			return true;
+		}
+	}
+
+	// Steal from the front of the other queues, the jobs their owners would take last.
+	for (natural offset = 1; offset < job_queues.size(); offset++) {
+		JobQueue &queue = *job_queues[(queue_index + offset) % job_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty()) {
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+			queued_jobs--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::_run_job(const Job &job) {
+	running_job = true;
+	(*job.function)(job.index);
+	running_job = false;
+	unfinished_jobs--;
+}
+
+bool ThreadPool::is_running_job() {
+	return running_job;
+}
+
+void ThreadPool::_worker_loop(const natural queue_index) {
+	while (true) {
+		Job job;
+		if (_pop_job(queue_index, job)) {
+			_run_job(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex);
+		wake_condition.wait(lock, [this]() {
+			return !running || queued_jobs > 0;
+		});
+
+		if (!running)
+			return;
+	}
+}
+
+void ThreadPool::parallel_for(const natural count, const std::function<void(natural)> &function) {
+	if (!count)
+		return;
+
+	const natural caller_queue_index = job_queues.size() - 1;
+
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		unfinished_jobs += count;
+
+		for (natural i = 0; i < count; i++) {
+			JobQueue &queue = *job_queues[i % job_queues.size()];
+			std::lock_guard<std::mutex> queue_lock(queue.mutex);
+			queue.jobs.push_back(Job{&function, i});
+			queued_jobs++;
+		}
+	}
+	wake_condition.notify_all();
+
+	while (unfinished_jobs > 0) {
+		Job job;
+		if (_pop_job(caller_queue_index, job))
+			_run_job(job);
+		else
+			std::this_thread::yield();
+	}
+}
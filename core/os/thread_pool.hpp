@@ -0,0 +1,104 @@
+/*  This file is part of the Toof Engine. */
+/** @file thread_pool.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Toof {
+
+/**
+* @brief A pool of worker threads that run jobs with work stealing.
+* @details Each thread has its own queue of jobs. A thread that runs out of jobs takes them from the front of the other queues,
+* so uneven jobs are still spread over all threads.
+*/
+class ThreadPool {
+	struct Job {
+		const std::function<void(natural)> *function;
+		natural index;
+	};
+
+	struct JobQueue {
+		std::deque<Job> jobs;
+		std::mutex mutex;
+	};
+
+	std::vector<std::thread> threads;
+	std::vector<std::unique_ptr<JobQueue>> job_queues;
+	std::mutex wake_mutex;
+	std::condition_variable wake_condition;
+	std::atomic<natural> queued_jobs;
+	std::atomic<natural> unfinished_jobs;
+	bool running;
+
+	bool _pop_job(const natural queue_index, Job &job);
+	void _run_job(const Job &job);
+	void _worker_loop(const natural queue_index);
+public:
+	/**
+	* @brief Creates a pool with @b thread_count worker threads.
+	* @details The thread calling @b parallel_for works as well, so by default one thread less than the hardware supports is created.
+	*/
+	explicit ThreadPool(const natural thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool &operator=(const ThreadPool&) = delete;
+
+	natural get_thread_count() const {
+		return threads.size();
+	}
+
+	/**
+	* @brief Calls @b function with every index from 0 to @b count - 1, spread over the worker threads and the calling thread.
+	* @details Returns once every call has finished, so it also acts as a barrier.
+	* @note The order and the thread the calls are made from are unspecified. Must not be called from inside @b function.
+	*/
+	void parallel_for(const natural count, const std::function<void(natural)> &function);
+
+	/**
+	* @brief Returns true if the calling thread is running a function passed to @b parallel_for of any ThreadPool.
+	*/
+	static bool is_running_job();
+};
+
+}
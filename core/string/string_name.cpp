@@ -80,8 +80,13 @@ void StringName::_reset() {
 		return;
 
 	if (!saved_string.is_used()) {
-		saved_string.delete_stored_string();
-		stored_strings.erase(*saved_string.stored_string);
+		// Erased before the string is deleted, as erasing hashes the string.
+		const __String_Saver__ erased_string = saved_string;
+		const CharT *string = erased_string.stored_string->string;
+
+		stored_strings.erase(*erased_string.stored_string);
+		delete[] string;
+		saved_string = __String_Saver__();
 	}
 }
 
@@ -94,7 +99,7 @@ const StringName::__String_Storer__ *StringName::_allocate_str(const CharT *stri
 
 	if (copy) {
 		const StringView::size_type str_size = storer.view.size();
-		char *str_copy = new char[str_size];
+		char *str_copy = new char[str_size + 1];
 
 		storer.view.copy(str_copy, str_size);
 		str_copy[str_size] = '\0';
@@ -116,7 +121,7 @@ const StringName::__String_Storer__ *StringName::_allocate_str(const_reference s
 
 	if (copy) {
 		const StringView::size_type str_size = storer.view.size();
-		char *str_copy = new char[str_size];
+		char *str_copy = new char[str_size + 1];
 
 		storer.view.copy(str_copy, str_size);
 		str_copy[str_size] = '\0';
@@ -179,6 +184,24 @@ StringName StringName::substr(const size_type pos, const size_type count) const
 	return saved_string->substr(pos, count);
 }
 
+void StringName::operator=(const StringName &string_name) {
+	if (saved_string.stored_string == string_name.saved_string.stored_string)
+		return;
+
+	_reset();
+	saved_string = string_name.saved_string;
+	saved_string.increment();
+}
+
+void StringName::operator=(StringName &&string_name) {
+	if (this == &string_name)
+		return;
+
+	_reset();
+	saved_string = string_name.saved_string;
+	string_name.saved_string = __String_Saver__();
+}
+
 void StringName::operator=(const_reference string) {
 	_set_string(string);
 }
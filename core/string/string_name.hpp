@@ -96,7 +96,7 @@ public:
 
 		constexpr void delete_stored_string() {
 			if (stored_string && stored_string->string)
-				delete stored_string->string;
+				delete[] stored_string->string;
 		}
 
 		constexpr bool operator==(const __String_Storer__ &string_saver) const {
@@ -193,6 +193,7 @@ public:
 
 	constexpr StringName(StringName &&string_name) {
 		saved_string = string_name.saved_string;
+		string_name.saved_string = __String_Saver__();
 	}
 
 	~StringName();
@@ -400,15 +401,8 @@ public:
 		return saved_string->find_last_not_of(string, pos);
 	}
 
-	constexpr void operator=(const StringName &string_name) {
-		saved_string = string_name.saved_string;
-		saved_string.increment();
-	}
-
-	constexpr void operator=(StringName &&string_name) {
-		saved_string = string_name.saved_string;
-		saved_string.increment();
-	}
+	void operator=(const StringName &string_name);
+	void operator=(StringName &&string_name);
 
 	void operator=(const_reference string);
 
@@ -30,20 +30,30 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include <input/input.hpp>
-#include <input/input_map.hpp>
+#include <input/input_recording.hpp>
+#include <core/os/profiler.hpp>
 
 #include <algorithm>
 
 using Input = Toof::Input;
 using InputEvent = Toof::InputEvent;
+using ActionHandle = Toof::ActionHandle;
 
 Input::Input(const uint64_t *process_frame_count, const uint64_t *render_frame_count):
             keys_pressed(),
+            character_keys_pressed(),
             physical_keys_pressed(),
             process_frame_count(process_frame_count),
             render_frame_count(render_frame_count),
             mouse_position(),
-            action_states() {
+            mouse_buttons_pressed(),
+            controller_buttons_pressed(),
+            controller_axis_values(),
+            action_states(),
+            event_arena(),
+            coalesced_events(),
+            recorder(nullptr),
+            coalescing_enabled(true) {
 	input_map = std::make_unique<InputMap>();
 }
 
@@ -54,8 +64,35 @@ const std::unique_ptr<Toof::InputMap> &Input::get_input_map() const {
 	return input_map;
 }
 
-void Input::_update_action_with_event(const String &action_name, const std::shared_ptr<InputEvent> &input_event) {
-	ActionState &action_state = action_states[action_name];
+ActionHandle Input::get_action_handle(const String &action_name) const {
+	return input_map->get_action_handle(action_name);
+}
+
+Input::ActionState &Input::_get_action_state(const ActionHandle action_handle) {
+	if (action_handle.id >= action_states.size())
+		action_states.resize(input_map->get_action_id_count());
+
+	// The action was cleared and created again since the state was last written, so the old state doesn't apply.
+	ActionState &action_state = action_states[action_handle.id];
+	const uint32_t generation = input_map->get_action_generation(action_handle);
+	if (action_state.generation != generation) {
+		action_state = ActionState();
+		action_state.generation = generation;
+	}
+
+	return action_state;
+}
+
+const Input::ActionState *Input::_find_action_state(const ActionHandle action_handle) const {
+	if (!input_map->has_action(action_handle) || action_handle.id >= action_states.size())
+		return nullptr;
+
+	const ActionState &action_state = action_states[action_handle.id];
+	return action_state.generation == input_map->get_action_generation(action_handle) ? &action_state : nullptr;
+}
+
+void Input::_update_action_with_event(const ActionHandle action_handle, const InputEvent *input_event) {
+	ActionState &action_state = _get_action_state(action_handle);
 
 	action_state.pressed = input_event->is_pressed();
 	if (action_state.pressed) {
@@ -75,129 +112,203 @@ void Input::_update_action_with_event(const String &action_name, const std::shar
 	action_state.strength = action_state.pressed;
 }
 
-std::shared_ptr<InputEvent> Input::_process_keyboard_event(const SDL_Event *event) {
+InputEvent *Input::_process_keyboard_event(const SDL_Event *event) {
 	const bool pressed = event->key.type == SDL_KEYDOWN;
-	const auto &physical_key_iterator = physical_keys_pressed.find(event->key.keysym.scancode);
-	const auto &key_iterator = keys_pressed.find(event->key.keysym.sym);
-
-	if (physical_key_iterator == physical_keys_pressed.end())
-		physical_keys_pressed.insert(event->key.keysym.scancode);
-	else if (!pressed)
-		physical_keys_pressed.erase(event->key.keysym.scancode);
-
-	if (key_iterator == keys_pressed.end())
-		keys_pressed.insert(event->key.keysym.sym);
-	else if (!pressed)
-		keys_pressed.erase(key_iterator);
-
-	auto input_event = std::make_unique<InputEventKeyboard>();
-	input_event->fill_with_event(event);
-	input_event->set_input(this);
+	const SDL_Scancode scan_code = event->key.keysym.scancode;
+	const SDL_Keycode key_code = event->key.keysym.sym;
+	const natural key_code_bit = _get_key_code_bit(key_code);
+
+	if (scan_code >= 0 && scan_code < SDL_NUM_SCANCODES)
+		physical_keys_pressed.set(scan_code, pressed);
+
+	if (key_code_bit < KEY_CODE_BITS)
+		keys_pressed.set(key_code_bit, pressed);
+	else if (pressed)
+		character_keys_pressed.insert(key_code);
+	else
+		character_keys_pressed.erase(key_code);
+
+	return _create_event<InputEventKeyboard>(event);
+}
+
+InputEvent *Input::_process_mouse_motion_event(const SDL_Event *event) {
+	mouse_position = Vector2f(event->motion.x, event->motion.y);
+	return _create_event<InputEventMouseMotion>(event);
+}
+
+InputEvent *Input::_process_mouse_button_event(const SDL_Event *event) {
+	if (event->button.button < MOUSE_BUTTON_BITS)
+		mouse_buttons_pressed.set(event->button.button, event->type == SDL_MOUSEBUTTONDOWN);
+
+	mouse_position = Vector2f(event->button.x, event->button.y);
+	return _create_event<InputEventMouseButton>(event);
+}
+
+InputEvent *Input::_process_controller_axis_event(const SDL_Event *event) {
+	InputEventControllerAxis *input_event = _create_event<InputEventControllerAxis>(event);
+	if (event->caxis.axis < SDL_CONTROLLER_AXIS_MAX)
+		controller_axis_values[event->caxis.axis] = input_event->get_axis_value();
+
 	return input_event;
 }
 
-std::shared_ptr<InputEvent> Input::process_event(const SDL_Event *event) {
+InputEvent *Input::_process_controller_button_event(const SDL_Event *event) {
+	if (event->cbutton.button < SDL_CONTROLLER_BUTTON_MAX)
+		controller_buttons_pressed.set(event->cbutton.button, event->type == SDL_CONTROLLERBUTTONDOWN);
+
+	return _create_event<InputEventControllerButton>(event);
+}
+
+void Input::_coalesce_event(InputEvent *input_event) {
+	for (InputEvent *coalesced_event: coalesced_events)
+		if (coalesced_event->accumulate(input_event))
+			return;
+
+	coalesced_events.push_back(input_event);
+}
+
+Toof::InputEventRef Input::process_event(const SDL_Event *event) {
+	TOOF_PROFILE_ZONE("Input::process_event");
 	EventInputType event_input_type = get_event_type(event);
-	std::shared_ptr<InputEvent> input_event;
+	InputEvent *input_event = nullptr;
 
 	switch (event_input_type) {
 		case EVENT_INPUT_TYPE_KEYBOARD:
 			input_event = _process_keyboard_event(event);
 			break;
+		case EVENT_INPUT_TYPE_MOUSE_MOTION:
+			input_event = _process_mouse_motion_event(event);
+			break;
+		case EVENT_INPUT_TYPE_MOUSE_BUTTON:
+			input_event = _process_mouse_button_event(event);
+			break;
+		case EVENT_INPUT_TYPE_CONTROLLER_AXIS:
+			input_event = _process_controller_axis_event(event);
+			break;
+		case EVENT_INPUT_TYPE_CONTROLLER_BUTTON:
+			input_event = _process_controller_button_event(event);
+			break;
 		default:
-			return std::shared_ptr<InputEvent>();
+			return InputEventRef();
 			break;
 	}
 
-	for (const auto &iterator: input_map->get_actions())
-		if (iterator.second.inputs.count(input_event))
-			_update_action_with_event(iterator.first, input_event);
+	if (recorder)
+		recorder->record(process_frame_count ? *process_frame_count : 0, event);
+
+	input_map->for_each_event_action(input_event, [this, input_event](const ActionHandle action_handle) {
+		_update_action_with_event(action_handle, input_event);
+	});
+
+	if (coalescing_enabled && is_coalesced_event_type(event_input_type)) {
+		_coalesce_event(input_event);
+		return InputEventRef();
+	}
 
 	return input_event;
 }
 
-const std::unordered_map<Toof::String, Input::ActionState> &Input::get_action_states() const {
+void Input::flush_events() {
+	coalesced_events.clear();
+	event_arena.reset();
+}
+
+const std::vector<Input::ActionState> &Input::get_action_states() const {
 	return action_states;
 }
 
 bool Input::is_anything_pressed() const {
-	if (!keys_pressed.empty() || !physical_keys_pressed.empty())
+	if (keys_pressed.any() || !character_keys_pressed.empty() || physical_keys_pressed.any())
+		return true;
+
+	if (mouse_buttons_pressed.any() || controller_buttons_pressed.any())
 		return true;
 
-	for (const auto &iterator: action_states)
-		if (iterator.second.pressed)
+	for (natural i = 0; i < action_states.size(); i++)
+		if (action_states[i].pressed && _find_action_state(ActionHandle {i}))
 			return true;
 
 	return false;
 }
 
 bool Input::is_key_pressed(const SDL_Keycode key_code) const {
-	return keys_pressed.count(key_code) == 1;
+	const natural key_code_bit = _get_key_code_bit(key_code);
+	if (key_code_bit < KEY_CODE_BITS)
+		return keys_pressed.test(key_code_bit);
+
+	return character_keys_pressed.count(key_code) == 1;
 }
 
 bool Input::is_physical_key_pressed(const SDL_Scancode scan_code) const {
-	return physical_keys_pressed.count(scan_code) == 1;
+	return scan_code >= 0 && scan_code < SDL_NUM_SCANCODES && physical_keys_pressed.test(scan_code);
 }
 
-bool Input::is_action_pressed(const String &action_name) const {
-	if (!input_map->has_action(action_name))
-		return false;
+bool Input::is_mouse_button_pressed(const uint8_t button) const {
+	return button < MOUSE_BUTTON_BITS && mouse_buttons_pressed.test(button);
+}
 
-	const auto &iterator = action_states.find(action_name);
-	const int b = action_states.count(action_name);
-	(void)b;
-	if (iterator == action_states.end())
-		return false;
-	return iterator->second.pressed;
+bool Input::is_controller_button_pressed(const SDL_GameControllerButton button) const {
+	return button >= 0 && button < SDL_CONTROLLER_BUTTON_MAX && controller_buttons_pressed.test(button);
 }
 
-bool Input::is_action_just_pressed(const String &action_name) const {
-	if (!input_map->has_action(action_name))
-		return false;
+float Input::get_controller_axis_value(const SDL_GameControllerAxis axis) const {
+	return axis >= 0 && axis < SDL_CONTROLLER_AXIS_MAX ? controller_axis_values[axis] : 0.0f;
+}
 
-	const auto &iterator = action_states.find(action_name);
-	if (iterator == action_states.end())
+bool Input::is_action_pressed(const ActionHandle action_handle) const {
+	const ActionState *action_state = _find_action_state(action_handle);
+	return action_state ? action_state->pressed : false;
+}
+
+bool Input::is_action_just_pressed(const ActionHandle action_handle) const {
+	const ActionState *action_state = _find_action_state(action_handle);
+	if (!action_state)
 		return false;
 
-	const ActionState &action_state = iterator->second;
 	if (process_frame_count && !render_frame_count)
-		return action_state.pressed_process_frame == *process_frame_count;
+		return action_state->pressed_process_frame == *process_frame_count;
 	else if (!process_frame_count && render_frame_count)
-		return action_state.pressed_render_frame == *render_frame_count;
+		return action_state->pressed_render_frame == *render_frame_count;
 	else if (process_frame_count && render_frame_count)
-		return action_state.pressed_process_frame == *process_frame_count;
+		return action_state->pressed_process_frame == *process_frame_count;
 
-	return action_state.pressed;
+	return action_state->pressed;
 }
 
-bool Input::is_action_just_released(const String &action_name) const {
-	if (!input_map->has_action(action_name))
+bool Input::is_action_just_released(const ActionHandle action_handle) const {
+	const ActionState *action_state = _find_action_state(action_handle);
+	if (!action_state)
 		return false;
 
-	const auto &iterator = action_states.find(action_name);
-	if (iterator == action_states.end())
-		return false;
-
-	const ActionState &action_state = iterator->second;
 	if (process_frame_count && !render_frame_count)
-		return action_state.released_process_frame == *process_frame_count;
+		return action_state->released_process_frame == *process_frame_count;
 	else if (!process_frame_count && render_frame_count)
-		return action_state.released_render_frame == *render_frame_count;
+		return action_state->released_render_frame == *render_frame_count;
 	else if (process_frame_count && render_frame_count)
-		return action_state.released_process_frame == *process_frame_count;
+		return action_state->released_process_frame == *process_frame_count;
 
-	return !action_state.pressed;
+	return !action_state->pressed;
 }
 
-float Input::get_action_strength(const String &action_name) const {
-	if (!input_map->has_action(action_name))
-		return 0.0f;
+float Input::get_action_strength(const ActionHandle action_handle) const {
+	const ActionState *action_state = _find_action_state(action_handle);
+	return action_state ? action_state->strength : 0.0f;
+}
 
-	const auto &iterator = action_states.find(action_name);
-	if (iterator == action_states.end())
-		return 0.0f;
+bool Input::is_action_pressed(const String &action_name) const {
+	return is_action_pressed(get_action_handle(action_name));
+}
+
+bool Input::is_action_just_pressed(const String &action_name) const {
+	return is_action_just_pressed(get_action_handle(action_name));
+}
 
-	return iterator->second.strength;
+bool Input::is_action_just_released(const String &action_name) const {
+	return is_action_just_released(get_action_handle(action_name));
+}
+
+float Input::get_action_strength(const String &action_name) const {
+	return get_action_strength(get_action_handle(action_name));
 }
 
 float Input::get_axis(const String &negative_action_name, const String &positive_action_name) const {
@@ -211,11 +322,11 @@ Toof::Vector2f Input::get_vector(const String &negative_x_action_name, const Str
 	return vector.normalized();
 }
 
-void Input::action_press(const String &action_name, const float strength) {
-	if (!input_map->has_action(action_name))
+void Input::action_press(const ActionHandle action_handle, const float strength) {
+	if (!input_map->has_action(action_handle))
 		return;
 
-	ActionState &action_state = action_states[action_name];
+	ActionState &action_state = _get_action_state(action_handle);
 
 	if (!action_state.pressed) {
 		if (process_frame_count)
@@ -232,11 +343,11 @@ void Input::action_press(const String &action_name, const float strength) {
 	action_state.strength = std::max(action_state.api_strength, action_state.strength);
 }
 
-void Input::action_release(const String &action_name) {
-	if (input_map->has_action(action_name))
+void Input::action_release(const ActionHandle action_handle) {
+	if (!input_map->has_action(action_handle))
 		return;
 
-	ActionState &action_state = action_states[action_name];
+	ActionState &action_state = _get_action_state(action_handle);
 
 	action_state.pressed = false;
 	action_state.strength = 0.0f;
@@ -249,3 +360,11 @@ void Input::action_release(const String &action_name) {
 	action_state.api_pressed = false;
 	action_state.api_strength = 0.0f;
 }
+
+void Input::action_press(const String &action_name, const float strength) {
+	action_press(get_action_handle(action_name), strength);
+}
+
+void Input::action_release(const String &action_name) {
+	action_release(get_action_handle(action_name));
+}
@@ -33,29 +33,27 @@
 #pragma once
 
 #include <core/math/vector2.hpp>
+#include <core/math/math_defs.hpp>
+#include <input/input_map.hpp>
+#include <input/input_event_arena.hpp>
 
+#include <array>
+#include <bitset>
 #include <unordered_set>
-#include <unordered_map>
 #include <memory>
+#include <vector>
 
 #include <SDL_keyboard.h>
 #include <SDL_events.h>
+#include <SDL_gamecontroller.h>
 
 namespace Toof {
 
-struct InputProxy;
-class InputMap;
-class InputEvent;
+class InputRecorder;
 
 class Input {
 
-private:
-	std::unordered_set<SDL_Keycode> keys_pressed;
-	std::unordered_set<SDL_Scancode> physical_keys_pressed;
-	std::unique_ptr<InputMap> input_map;
-	const uint64_t *process_frame_count, *render_frame_count;
-	Vector2f mouse_position;
-
+public:
 	struct ActionState {
 		uint64_t pressed_render_frame = -1;
 		uint64_t pressed_process_frame = -1;
@@ -66,26 +64,174 @@ private:
 
 		float api_strength = 0.0;
 		float strength = 0.0f;
+
+		// The generation of the action this state belongs to, see @b InputMap::get_action_generation.
+		uint32_t generation = 0;
 	};
 
-	std::unordered_map<String, ActionState> action_states;
+	/**
+	* @brief The amount of key codes stored in a bitset, the 128 ASCII key codes followed by the key codes made from a scan code.
+	*/
+	static constexpr natural KEY_CODE_BITS = 128 + SDL_NUM_SCANCODES;
 
-	void _update_action_with_event(const String &action_name, const std::shared_ptr<InputEvent> &input_event);
-	void _flush_buffered_inputs();
+	static constexpr natural MOUSE_BUTTON_BITS = 32;
 
-	std::shared_ptr<InputEvent> _process_keyboard_event(const SDL_Event *event);
+private:
+	std::bitset<KEY_CODE_BITS> keys_pressed;
+	std::unordered_set<SDL_Keycode> character_keys_pressed;
+	std::bitset<SDL_NUM_SCANCODES> physical_keys_pressed;
+	std::unique_ptr<InputMap> input_map;
+	const uint64_t *process_frame_count, *render_frame_count;
+	Vector2f mouse_position;
+	std::bitset<MOUSE_BUTTON_BITS> mouse_buttons_pressed;
+	std::bitset<SDL_CONTROLLER_BUTTON_MAX> controller_buttons_pressed;
+	std::array<float, SDL_CONTROLLER_AXIS_MAX> controller_axis_values;
+
+	std::vector<ActionState> action_states;
+	detail::InputEventArena event_arena;
+	std::vector<InputEvent*> coalesced_events;
+	InputRecorder *recorder;
+	bool coalescing_enabled;
+
+	static constexpr natural _get_key_code_bit(const SDL_Keycode key_code) {
+		if (key_code >= 0 && key_code < 128)
+			return key_code;
+
+		const natural scan_code = key_code & ~SDLK_SCANCODE_MASK;
+		if ((key_code & SDLK_SCANCODE_MASK) && scan_code < SDL_NUM_SCANCODES)
+			return 128 + scan_code;
+
+		return KEY_CODE_BITS;
+	}
+
+	ActionState &_get_action_state(const ActionHandle action_handle);
+	const ActionState *_find_action_state(const ActionHandle action_handle) const;
+	void _update_action_with_event(const ActionHandle action_handle, const InputEvent *input_event);
+
+	template<class T>
+	T *_create_event(const SDL_Event *event) {
+		T *input_event = event_arena.create<T>();
+		input_event->fill_with_event(event);
+		input_event->set_input(this);
+		return input_event;
+	}
+
+	InputEvent *_process_keyboard_event(const SDL_Event *event);
+	InputEvent *_process_mouse_motion_event(const SDL_Event *event);
+	InputEvent *_process_mouse_button_event(const SDL_Event *event);
+	InputEvent *_process_controller_axis_event(const SDL_Event *event);
+	InputEvent *_process_controller_button_event(const SDL_Event *event);
+	void _coalesce_event(InputEvent *input_event);
 public:
 	Input(const uint64_t *process_frame_count = nullptr, const uint64_t *render_frame_count = nullptr);
 	~Input();
 
-	std::shared_ptr<InputEvent> process_event(const SDL_Event *event);
-	const std::unordered_map<String, ActionState> &get_action_states() const;
+	/**
+	* @brief Updates the key and action states with @b event and returns it as an InputEvent, or an empty reference if the event isn't an input event.
+	* @details The InputEvent is stored in the event arena until @b flush_events is called, see @b InputEventRef.
+	* If coalescing is enabled, mouse motion and controller axis events are merged into the pending events instead and an empty reference is returned.
+	*/
+	InputEventRef process_event(const SDL_Event *event);
+
+	/**
+	* @brief Releases the InputEvents created since the previous call, their memory is reused by the next events.
+	* @details Called by the SceneTree at the end of every process step. Coalesced events that weren't flushed are dropped.
+	*/
+	void flush_events();
+
+	/**
+	* @brief Returns @b true for the event types that are merged while coalescing is enabled, mouse motion and controller axis motion.
+	*/
+	static constexpr bool is_coalesced_event_type(const EventInputType event_input_type) {
+		return event_input_type == EVENT_INPUT_TYPE_MOUSE_MOTION || event_input_type == EVENT_INPUT_TYPE_CONTROLLER_AXIS;
+	}
+
+	/**
+	* @brief If true, consecutive mouse motion and controller axis events are merged into one event per mouse and per controller axis.
+	* @details The merged events hold the latest position or axis value, and mouse motion events the relative motion of all merged events.
+	* That way the amount of events propagated per frame doesn't depend on the polling rate of the devices. Enabled by default.
+	* @see @b flush_coalesced_events.
+	*/
+	constexpr void set_coalescing_enabled(const bool enabled) {
+		coalescing_enabled = enabled;
+	}
+
+	constexpr bool is_coalescing_enabled() const {
+		return coalescing_enabled;
+	}
+
+	/**
+	* @brief Calls @b function with each merged event and removes them.
+	* @details The SceneTree calls this before any event that isn't merged, to keep the order of the events, and at the start of every process step.
+	* Can be called again from @b function, events merged while flushing are kept for the next flush.
+	*/
+	template<class F>
+	void flush_coalesced_events(const F &function) {
+		// Taken out of the member first, so a nested flush doesn't send the same events again.
+		std::vector<InputEvent*> flushing_events;
+		flushing_events.swap(coalesced_events);
+
+		for (InputEvent *coalesced_event: flushing_events)
+			function(InputEventRef(coalesced_event));
+
+		// Give the buffer back so that steady-state flushes don't reallocate it.
+		if (coalesced_events.empty()) {
+			flushing_events.clear();
+			coalesced_events.swap(flushing_events);
+		}
+	}
+
+	natural get_coalesced_event_count() const {
+		return coalesced_events.size();
+	}
+
+	constexpr natural get_event_count() const {
+		return event_arena.get_event_count();
+	}
+
+	/**
+	* @brief Records every SDL event that @b process_event turns into an InputEvent into @b recorder, or stops recording if @b recorder is nullptr.
+	* @details The events are recorded with the current process frame, see @b SceneTree::set_input_player to play them back.
+	*/
+	constexpr void set_recorder(InputRecorder *recorder) {
+		this->recorder = recorder;
+	}
+
+	constexpr InputRecorder *get_recorder() const {
+		return recorder;
+	}
+
+	/**
+	* @brief Returns the state of every action, indexed by the id of the action handle. Actions without a state yet are missing at the end.
+	*/
+	const std::vector<ActionState> &get_action_states() const;
 
 	const std::unique_ptr<InputMap> &get_input_map() const;
 
+	/**
+	* @brief Shorthand for @b InputMap::get_action_handle. Resolve the handles once and use the handle overloads to poll actions each frame without hashing the name.
+	*/
+	ActionHandle get_action_handle(const String &action_name) const;
+
 	bool is_anything_pressed() const;
 	bool is_key_pressed(const SDL_Keycode keycode) const;
 	bool is_physical_key_pressed(const SDL_Scancode scan_code) const;
+	bool is_mouse_button_pressed(const uint8_t button) const;
+	bool is_controller_button_pressed(const SDL_GameControllerButton button) const;
+
+	/**
+	* @brief Returns the latest value between -1 and 1 of @b axis, of the controller that moved it last.
+	*/
+	float get_controller_axis_value(const SDL_GameControllerAxis axis) const;
+
+	constexpr const Vector2f &get_mouse_position() const {
+		return mouse_position;
+	}
+
+	bool is_action_pressed(const ActionHandle action_handle) const;
+	bool is_action_just_pressed(const ActionHandle action_handle) const;
+	bool is_action_just_released(const ActionHandle action_handle) const;
+	float get_action_strength(const ActionHandle action_handle) const;
 
 	bool is_action_pressed(const String &action_name) const;
 	bool is_action_just_pressed(const String &action_name) const;
@@ -95,6 +241,9 @@ public:
 	float get_axis(const String &negative_action_name, const String &positive_action_name) const;
 	Vector2f get_vector(const String &negative_x_action_name, const String &positive_x_action_name, const String &negative_y_action_name, const String &positive_y_action_name) const;
 
+	void action_press(const ActionHandle action_handle, const float strength = 1.0f);
+	void action_release(const ActionHandle action_handle);
+
 	void action_press(const String &action_name, const float strength = 1.0f);
 	void action_release(const String &action_name);
 };
@@ -35,6 +35,10 @@
 
 using InputEvent = Toof::InputEvent;
 using InputEventKeyboard = Toof::InputEventKeyboard;
+using InputEventMouseMotion = Toof::InputEventMouseMotion;
+using InputEventMouseButton = Toof::InputEventMouseButton;
+using InputEventControllerAxis = Toof::InputEventControllerAxis;
+using InputEventControllerButton = Toof::InputEventControllerButton;
 using InputEventAction = Toof::InputEventAction;
 
 bool InputEvent::is_action(const String &action_name) const {
@@ -60,6 +64,25 @@ bool InputEvent::same_input(const InputEvent *input_event) const {
 	return _same_input(input_event);
 }
 
+std::shared_ptr<InputEvent> InputEvent::_duplicate() const {
+	return std::make_shared<InputEvent>(*this);
+}
+
+std::shared_ptr<InputEvent> InputEvent::duplicate() const {
+	return _duplicate();
+}
+
+bool InputEvent::accumulate(const InputEvent *input_event) {
+	if (!input_event || type != input_event->type)
+		return false;
+
+	return _accumulate(input_event);
+}
+
+std::shared_ptr<InputEvent> InputEventKeyboard::_duplicate() const {
+	return std::make_shared<InputEventKeyboard>(*this);
+}
+
 bool InputEventKeyboard::_same_input(const InputEvent *input_event) const {
 	const InputEventKeyboard *input_event_keyboard = static_cast<const InputEventKeyboard*>(input_event);
 	return (key_code == input_event_keyboard->key_code || scan_code == input_event_keyboard->scan_code)
@@ -77,7 +100,105 @@ void InputEventKeyboard::_fill_with_event(const SDL_Event *event) {
 	pressed = event->type == SDL_KEYDOWN;
 }
 
+void InputEventMouseMotion::_fill_with_event(const SDL_Event *event) {
+	if (get_event_type(event) != EVENT_INPUT_TYPE_MOUSE_MOTION)
+		return;
+
+	position = Vector2i32(event->motion.x, event->motion.y);
+	relative = Vector2i32(event->motion.xrel, event->motion.yrel);
+	button_state = event->motion.state;
+	mouse_id = event->motion.which;
+	time_stamp = event->motion.timestamp;
+}
+
+std::shared_ptr<InputEvent> InputEventMouseMotion::_duplicate() const {
+	return std::make_shared<InputEventMouseMotion>(*this);
+}
+
+bool InputEventMouseMotion::_accumulate(const InputEvent *input_event) {
+	const InputEventMouseMotion *input_event_mouse_motion = static_cast<const InputEventMouseMotion*>(input_event);
+	if (mouse_id != input_event_mouse_motion->mouse_id)
+		return false;
+
+	position = input_event_mouse_motion->position;
+	relative += input_event_mouse_motion->relative;
+	button_state = input_event_mouse_motion->button_state;
+	time_stamp = input_event_mouse_motion->time_stamp;
+	return true;
+}
+
+void InputEventMouseButton::_fill_with_event(const SDL_Event *event) {
+	if (get_event_type(event) != EVENT_INPUT_TYPE_MOUSE_BUTTON)
+		return;
+
+	position = Vector2i32(event->button.x, event->button.y);
+	mouse_id = event->button.which;
+	time_stamp = event->button.timestamp;
+	button = event->button.button;
+	clicks = event->button.clicks;
+	pressed = event->type == SDL_MOUSEBUTTONDOWN;
+}
+
+bool InputEventMouseButton::_same_input(const InputEvent *input_event) const {
+	return button == static_cast<const InputEventMouseButton*>(input_event)->button;
+}
+
+std::shared_ptr<InputEvent> InputEventMouseButton::_duplicate() const {
+	return std::make_shared<InputEventMouseButton>(*this);
+}
+
+void InputEventControllerAxis::_fill_with_event(const SDL_Event *event) {
+	if (get_event_type(event) != EVENT_INPUT_TYPE_CONTROLLER_AXIS)
+		return;
+
+	controller_id = event->caxis.which;
+	time_stamp = event->caxis.timestamp;
+	value = event->caxis.value;
+	axis = event->caxis.axis;
+}
+
+bool InputEventControllerAxis::_same_input(const InputEvent *input_event) const {
+	return axis == static_cast<const InputEventControllerAxis*>(input_event)->axis;
+}
+
+std::shared_ptr<InputEvent> InputEventControllerAxis::_duplicate() const {
+	return std::make_shared<InputEventControllerAxis>(*this);
+}
+
+bool InputEventControllerAxis::_accumulate(const InputEvent *input_event) {
+	const InputEventControllerAxis *input_event_controller_axis = static_cast<const InputEventControllerAxis*>(input_event);
+	if (controller_id != input_event_controller_axis->controller_id || axis != input_event_controller_axis->axis)
+		return false;
+
+	// The value of an axis is absolute, so only the latest value matters.
+	value = input_event_controller_axis->value;
+	time_stamp = input_event_controller_axis->time_stamp;
+	return true;
+}
+
+void InputEventControllerButton::_fill_with_event(const SDL_Event *event) {
+	if (get_event_type(event) != EVENT_INPUT_TYPE_CONTROLLER_BUTTON)
+		return;
+
+	controller_id = event->cbutton.which;
+	time_stamp = event->cbutton.timestamp;
+	button = event->cbutton.button;
+	pressed = event->type == SDL_CONTROLLERBUTTONDOWN;
+}
+
+bool InputEventControllerButton::_same_input(const InputEvent *input_event) const {
+	return button == static_cast<const InputEventControllerButton*>(input_event)->button;
+}
+
+std::shared_ptr<InputEvent> InputEventControllerButton::_duplicate() const {
+	return std::make_shared<InputEventControllerButton>(*this);
+}
+
 bool InputEventAction::_same_input(const InputEvent *input_event) const {
 	const InputEventAction *input_event_action = static_cast<const InputEventAction*>(input_event);
 	return action_name == input_event_action->action_name && strength == input_event_action->strength;
+}
+
+std::shared_ptr<InputEvent> InputEventAction::_duplicate() const {
+	return std::make_shared<InputEventAction>(*this);
 }
\ No newline at end of file
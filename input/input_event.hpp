@@ -33,9 +33,12 @@
 #pragma once
 
 #include <core/string/string_def.hpp>
+#include <core/math/vector2.hpp>
 #include <input/event_input_type.hpp>
 #include <scene/resources/resource.hpp>
 
+#include <memory>
+
 namespace Toof {
 
 class Input;
@@ -52,6 +55,12 @@ private:
 	virtual void _fill_with_event(const SDL_Event*) {
 	}
 
+	virtual std::shared_ptr<InputEvent> _duplicate() const;
+
+	virtual bool _accumulate(const InputEvent*) {
+		return false;
+	}
+
 protected:
 	bool pressed;
 	EventInputType type;
@@ -78,6 +87,65 @@ public:
 
 	void fill_with_event(const SDL_Event *event);
 	bool same_input(const InputEvent *input_event) const;
+
+	/**
+	* @brief Returns a copy of the event that is owned by the caller.
+	*/
+	std::shared_ptr<InputEvent> duplicate() const;
+
+	/**
+	* @brief Merges @b input_event, which happened after this event, into this event.
+	* @details Only motion events can be merged, like mouse motion with the relative motion added up, or controller axis motion of the same axis.
+	* @returns @b false and leaves this event unchanged if the events can't be merged.
+	*/
+	bool accumulate(const InputEvent *input_event);
+};
+
+/**
+* @brief A reference to an InputEvent that doesn't own it, passed to the nodes when an event is propagated.
+* @details Events created by Input are stored in a per-frame arena and stay valid until the end of the next process step.
+* Call @b retain to keep the event for longer.
+*/
+class InputEventRef {
+	const InputEvent *input_event;
+
+public:
+	constexpr InputEventRef(): input_event(nullptr) {
+	}
+
+	constexpr InputEventRef(const InputEvent *input_event): input_event(input_event) {
+	}
+
+	constexpr const InputEvent *get() const {
+		return input_event;
+	}
+
+	constexpr const InputEvent *operator->() const {
+		return input_event;
+	}
+
+	constexpr const InputEvent &operator*() const {
+		return *input_event;
+	}
+
+	constexpr explicit operator bool() const {
+		return input_event;
+	}
+
+	/**
+	* @brief Returns the event as a @b T, or nullptr if it isn't one.
+	*/
+	template<class T>
+	const T *cast_to() const {
+		return dynamic_cast<const T*>(input_event);
+	}
+
+	/**
+	* @brief Returns a copy of the event that stays valid after the frame ends.
+	*/
+	std::shared_ptr<InputEvent> retain() const {
+		return input_event ? input_event->duplicate() : std::shared_ptr<InputEvent>();
+	}
 };
 
 // Equal to EVENT_INPUT_TYPE_KEYBOARD
@@ -90,6 +158,7 @@ private:
 
 	void _fill_with_event(const SDL_Event *event) override;
 	bool _same_input(const InputEvent *input_event) const override;
+	std::shared_ptr<InputEvent> _duplicate() const override;
 public:
 	constexpr InputEventKeyboard(): key_code(SDLK_UNKNOWN), scan_code(SDL_SCANCODE_UNKNOWN), time_stamp(0), modifiers(0) {
 		type = EVENT_INPUT_TYPE_KEYBOARD;
@@ -128,6 +197,230 @@ public:
 	}
 };
 
+// Equal to EVENT_INPUT_TYPE_MOUSE_MOTION
+class InputEventMouseMotion : public InputEvent {
+private:
+	Vector2i32 position;
+	Vector2i32 relative;
+	uint32_t button_state;
+	uint32_t mouse_id;
+	uint32_t time_stamp;
+
+	void _fill_with_event(const SDL_Event *event) override;
+	std::shared_ptr<InputEvent> _duplicate() const override;
+	bool _accumulate(const InputEvent *input_event) override;
+public:
+	constexpr InputEventMouseMotion(): position(), relative(), button_state(0), mouse_id(0), time_stamp(0) {
+		type = EVENT_INPUT_TYPE_MOUSE_MOTION;
+	}
+
+	constexpr void set_position(const Vector2i32 &position) {
+		this->position = position;
+	}
+
+	constexpr const Vector2i32 &get_position() const {
+		return position;
+	}
+
+	/**
+	* @brief Sets the motion since the previous mouse motion event. Accumulated events hold the motion of all merged events.
+	*/
+	constexpr void set_relative(const Vector2i32 &relative) {
+		this->relative = relative;
+	}
+
+	constexpr const Vector2i32 &get_relative() const {
+		return relative;
+	}
+
+	constexpr void set_button_state(const uint32_t button_state) {
+		this->button_state = button_state;
+	}
+
+	constexpr uint32_t get_button_state() const {
+		return button_state;
+	}
+
+	constexpr void set_mouse_id(const uint32_t mouse_id) {
+		this->mouse_id = mouse_id;
+	}
+
+	constexpr uint32_t get_mouse_id() const {
+		return mouse_id;
+	}
+
+	constexpr void set_time_stamp(const uint32_t time_stamp) {
+		this->time_stamp = time_stamp;
+	}
+
+	constexpr uint32_t get_time_stamp() const {
+		return time_stamp;
+	}
+};
+
+// Equal to EVENT_INPUT_TYPE_MOUSE_BUTTON
+class InputEventMouseButton : public InputEvent {
+private:
+	Vector2i32 position;
+	uint32_t mouse_id;
+	uint32_t time_stamp;
+	uint8_t button;
+	uint8_t clicks;
+
+	void _fill_with_event(const SDL_Event *event) override;
+	bool _same_input(const InputEvent *input_event) const override;
+	std::shared_ptr<InputEvent> _duplicate() const override;
+public:
+	constexpr InputEventMouseButton(): position(), mouse_id(0), time_stamp(0), button(0), clicks(0) {
+		type = EVENT_INPUT_TYPE_MOUSE_BUTTON;
+	}
+
+	constexpr void set_pressed(const bool pressed) {
+		this->pressed = pressed;
+	}
+
+	constexpr void set_position(const Vector2i32 &position) {
+		this->position = position;
+	}
+
+	constexpr const Vector2i32 &get_position() const {
+		return position;
+	}
+
+	constexpr void set_button(const uint8_t button) {
+		this->button = button;
+	}
+
+	constexpr uint8_t get_button() const {
+		return button;
+	}
+
+	constexpr void set_clicks(const uint8_t clicks) {
+		this->clicks = clicks;
+	}
+
+	constexpr uint8_t get_clicks() const {
+		return clicks;
+	}
+
+	constexpr void set_mouse_id(const uint32_t mouse_id) {
+		this->mouse_id = mouse_id;
+	}
+
+	constexpr uint32_t get_mouse_id() const {
+		return mouse_id;
+	}
+
+	constexpr void set_time_stamp(const uint32_t time_stamp) {
+		this->time_stamp = time_stamp;
+	}
+
+	constexpr uint32_t get_time_stamp() const {
+		return time_stamp;
+	}
+};
+
+// Equal to EVENT_INPUT_TYPE_CONTROLLER_AXIS
+class InputEventControllerAxis : public InputEvent {
+private:
+	int32_t controller_id;
+	uint32_t time_stamp;
+	int16_t value;
+	uint8_t axis;
+
+	void _fill_with_event(const SDL_Event *event) override;
+	bool _same_input(const InputEvent *input_event) const override;
+	std::shared_ptr<InputEvent> _duplicate() const override;
+	bool _accumulate(const InputEvent *input_event) override;
+public:
+	constexpr InputEventControllerAxis(): controller_id(0), time_stamp(0), value(0), axis(0) {
+		type = EVENT_INPUT_TYPE_CONTROLLER_AXIS;
+	}
+
+	constexpr void set_controller_id(const int32_t controller_id) {
+		this->controller_id = controller_id;
+	}
+
+	constexpr int32_t get_controller_id() const {
+		return controller_id;
+	}
+
+	constexpr void set_axis(const uint8_t axis) {
+		this->axis = axis;
+	}
+
+	constexpr uint8_t get_axis() const {
+		return axis;
+	}
+
+	constexpr void set_value(const int16_t value) {
+		this->value = value;
+	}
+
+	constexpr int16_t get_value() const {
+		return value;
+	}
+
+	/**
+	* @brief Returns the value of the axis between -1 and 1.
+	*/
+	constexpr float get_axis_value() const {
+		return value < -32767 ? -1.0f : value / 32767.0f;
+	}
+
+	constexpr void set_time_stamp(const uint32_t time_stamp) {
+		this->time_stamp = time_stamp;
+	}
+
+	constexpr uint32_t get_time_stamp() const {
+		return time_stamp;
+	}
+};
+
+// Equal to EVENT_INPUT_TYPE_CONTROLLER_BUTTON
+class InputEventControllerButton : public InputEvent {
+private:
+	int32_t controller_id;
+	uint32_t time_stamp;
+	uint8_t button;
+
+	void _fill_with_event(const SDL_Event *event) override;
+	bool _same_input(const InputEvent *input_event) const override;
+	std::shared_ptr<InputEvent> _duplicate() const override;
+public:
+	constexpr InputEventControllerButton(): controller_id(0), time_stamp(0), button(0) {
+		type = EVENT_INPUT_TYPE_CONTROLLER_BUTTON;
+	}
+
+	constexpr void set_pressed(const bool pressed) {
+		this->pressed = pressed;
+	}
+
+	constexpr void set_controller_id(const int32_t controller_id) {
+		this->controller_id = controller_id;
+	}
+
+	constexpr int32_t get_controller_id() const {
+		return controller_id;
+	}
+
+	constexpr void set_button(const uint8_t button) {
+		this->button = button;
+	}
+
+	constexpr uint8_t get_button() const {
+		return button;
+	}
+
+	constexpr void set_time_stamp(const uint32_t time_stamp) {
+		this->time_stamp = time_stamp;
+	}
+
+	constexpr uint32_t get_time_stamp() const {
+		return time_stamp;
+	}
+};
+
 // Equal to EVENT_INPUT_TYPE_USER << EVENT_INPUT_TYPE_WINDOW
 class InputEventAction : public InputEvent {
 private:
@@ -135,6 +428,7 @@ private:
 	float strength;
 
 	bool _same_input(const InputEvent *input_event) const override;
+	std::shared_ptr<InputEvent> _duplicate() const override;
 public:
 	InputEventAction(): action_name(), strength(0.0f) {
 		type = (EventInputType)(EVENT_INPUT_TYPE_USER << EVENT_INPUT_TYPE_WINDOW);
@@ -0,0 +1,107 @@
+/*  This file is part of the Toof Engine. */
+/** @file input_event_arena.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+#include <input/input_event.hpp>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace Toof {
+
+namespace detail {
+
+/**
+* @brief Reuses the InputEvents of type @b T created since the last reset.
+* @details The events are allocated once and kept between resets, so creating events doesn't allocate once enough of them exist.
+*/
+template<class T>
+class InputEventPool {
+	std::vector<std::unique_ptr<T>> events;
+	natural used_count = 0;
+
+public:
+	T *create() {
+		if (used_count == events.size())
+			events.push_back(std::make_unique<T>());
+
+		T *input_event = events[used_count++].get();
+		*input_event = T();
+		return input_event;
+	}
+
+	constexpr void reset() {
+		used_count = 0;
+	}
+
+	constexpr natural get_used_count() const {
+		return used_count;
+	}
+};
+
+/**
+* @brief Holds the InputEvents created by Input in the current frame, every event type in its own InputEventPool.
+*/
+template<class... Types>
+class BasicInputEventArena {
+	std::tuple<InputEventPool<Types>...> pools;
+
+public:
+	template<class T>
+	T *create() {
+		return std::get<InputEventPool<T>>(pools).create();
+	}
+
+	/**
+	* @brief Makes the memory of all events available again, references to them become invalid.
+	*/
+	constexpr void reset() {
+		std::apply([](InputEventPool<Types>&... event_pools) {
+			(event_pools.reset(), ...);
+		}, pools);
+	}
+
+	constexpr natural get_event_count() const {
+		return std::apply([](const InputEventPool<Types>&... event_pools) {
+			return (event_pools.get_used_count() + ... + 0);
+		}, pools);
+	}
+};
+
+using InputEventArena = BasicInputEventArena<InputEventKeyboard, InputEventMouseMotion, InputEventMouseButton, InputEventControllerAxis, InputEventControllerButton, InputEventAction>;
+
+}
+
+}
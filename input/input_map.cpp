@@ -34,31 +34,124 @@
 
 using namespace Toof;
 
-InputMap::InputMap(): actions() {
+InputMap::InputMap(): actions(),
+    action_handles(),
+    action_names(),
+    created_actions(),
+    action_generations(),
+    input_actions() {
 }
 
 InputMap::~InputMap() {
 }
 
+natural InputMap::_get_input_keys(const InputEvent *input_event, detail::InputKey *input_keys) {
+	if (!input_event)
+		return 0;
+
+	switch (input_event->get_type()) {
+		case EVENT_INPUT_TYPE_KEYBOARD: {
+			const InputEventKeyboard *input_event_keyboard = static_cast<const InputEventKeyboard*>(input_event);
+			input_keys[0] = {EVENT_INPUT_TYPE_KEYBOARD, input_event_keyboard->get_keycode(), input_event_keyboard->get_modifiers(), false};
+			input_keys[1] = {EVENT_INPUT_TYPE_KEYBOARD, input_event_keyboard->get_scan_code(), input_event_keyboard->get_modifiers(), true};
+			return 2;
+		}
+		case EVENT_INPUT_TYPE_MOUSE_BUTTON:
+			input_keys[0] = {EVENT_INPUT_TYPE_MOUSE_BUTTON, static_cast<const InputEventMouseButton*>(input_event)->get_button(), 0, false};
+			return 1;
+		case EVENT_INPUT_TYPE_CONTROLLER_BUTTON:
+			input_keys[0] = {EVENT_INPUT_TYPE_CONTROLLER_BUTTON, static_cast<const InputEventControllerButton*>(input_event)->get_button(), 0, false};
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+void InputMap::_index_input(const ActionHandle action_handle, const InputProxy &input_proxy) {
+	detail::InputKey input_keys[MAX_INPUT_KEYS];
+	const natural input_key_count = _get_input_keys(input_proxy.input_event.get(), input_keys);
+
+	for (natural i = 0; i < input_key_count; i++) {
+		std::vector<ActionHandle> &key_actions = input_actions[input_keys[i]];
+		if (std::find(key_actions.begin(), key_actions.end(), action_handle) == key_actions.end())
+			key_actions.push_back(action_handle);
+	}
+}
+
+void InputMap::_unindex_input(const Action &action, const InputProxy &input_proxy) {
+	detail::InputKey input_keys[MAX_INPUT_KEYS];
+	const natural input_key_count = _get_input_keys(input_proxy.input_event.get(), input_keys);
+
+	for (natural i = 0; i < input_key_count; i++) {
+		const auto &iterator = input_actions.find(input_keys[i]);
+		if (iterator == input_actions.end())
+			continue;
+
+		// Another input of the action can have the same key, for example the same key code with a different scan code.
+		bool key_still_bound = false;
+		for (const InputProxy &action_input: action.inputs) {
+			detail::InputKey action_input_keys[MAX_INPUT_KEYS];
+			const natural action_input_key_count = _get_input_keys(action_input.input_event.get(), action_input_keys);
+			key_still_bound = std::find(action_input_keys, action_input_keys + action_input_key_count, input_keys[i]) != action_input_keys + action_input_key_count;
+			if (key_still_bound)
+				break;
+		}
+
+		if (key_still_bound)
+			continue;
+
+		std::vector<ActionHandle> &key_actions = iterator->second;
+		key_actions.erase(std::remove(key_actions.begin(), key_actions.end(), action.handle), key_actions.end());
+		if (key_actions.empty())
+			input_actions.erase(iterator);
+	}
+}
+
 void InputMap::_add_input_to_action(const String &action_name, const InputProxy &input_proxy) {
 	const auto &iterator = actions.find(action_name);
+	if (iterator == actions.end() || !input_proxy.input_event)
+		return;
 
-	if (iterator != actions.end())
-		iterator->second.inputs.insert(std::move(input_proxy));
+	std::vector<InputProxy> &inputs = iterator->second.inputs;
+	if (std::find(inputs.begin(), inputs.end(), input_proxy) != inputs.end())
+		return;
+
+	inputs.push_back(input_proxy);
+	_index_input(iterator->second.handle, input_proxy);
 }
 
 void InputMap::_remove_input_from_action(const String &action_name, const InputProxy &input_proxy) {
 	const auto &iterator = actions.find(action_name);
+	if (iterator == actions.end() || !input_proxy.input_event)
+		return;
 
-	if (iterator != actions.end())
-		iterator->second.inputs.erase(input_proxy);
+	std::vector<InputProxy> &inputs = iterator->second.inputs;
+	const auto &input_iterator = std::find(inputs.begin(), inputs.end(), input_proxy);
+	if (input_iterator == inputs.end())
+		return;
+
+	const InputProxy removed_input = *input_iterator;
+	inputs.erase(input_iterator);
+	_unindex_input(iterator->second, removed_input);
 }
 
-void InputMap::create_action(const String &action_name) {
+ActionHandle InputMap::create_action(const String &action_name) {
 	const auto &iterator = actions.find(action_name);
-
-	if (iterator == actions.end())
-		actions.insert({action_name, {}});
+	if (iterator != actions.end())
+		return iterator->second.handle;
+
+	ActionHandle &action_handle = action_handles[action_name];
+	if (!action_handle.is_valid()) {
+		action_handle.id = action_names.size();
+		action_names.push_back(action_name);
+		created_actions.push_back(false);
+		action_generations.push_back(0);
+	}
+
+	created_actions[action_handle.id] = true;
+	action_generations[action_handle.id]++;
+	actions.insert({action_name, {{}, action_handle}});
+	return action_handle;
 }
 
 void InputMap::add_key_to_action(const String &action_name, const std::shared_ptr<InputEvent> &input_event) {
@@ -75,9 +168,24 @@ bool InputMap::has_action(const String &action_name) const {
 
 void InputMap::clear_action(const String &action_name) {
 	const auto &iterator = actions.find(action_name);
+	if (iterator == actions.end())
+		return;
 
-	if (iterator != actions.end())
-		actions.erase(iterator);
+	const Action removed_action = {{}, iterator->second.handle};
+	for (const InputProxy &input_proxy: iterator->second.inputs)
+		_unindex_input(removed_action, input_proxy);
+
+	created_actions[removed_action.handle.id] = false;
+	actions.erase(iterator);
+}
+
+ActionHandle InputMap::get_action_handle(const String &action_name) const {
+	const auto &iterator = action_handles.find(action_name);
+	return iterator == action_handles.end() ? ActionHandle() : iterator->second;
+}
+
+String InputMap::get_action_name(const ActionHandle action_handle) const {
+	return action_handle.id < action_names.size() ? action_names[action_handle.id] : String();
 }
 
 std::vector<InputEvent> InputMap::action_get_events(const String &action_name) const {
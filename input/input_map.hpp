@@ -34,25 +34,85 @@
 
 #include <input/input_event.hpp>
 #include <input/input_proxy.hpp>
+#include <core/math/math_defs.hpp>
 
 #include <SDL_keycode.h>
 
+#include <algorithm>
 #include <unordered_map>
-#include <set>
 #include <memory>
 #include <vector>
 
 namespace Toof {
 
+namespace detail {
+
+/**
+* @brief Identifies a physical input, an InputEvent matches an action when it has the same InputKey as one of the inputs of the action.
+* @details Keyboard events have two keys, one for the key code and one for the scan code. Mouse and controller buttons have one key per button.
+* Motion events don't have keys, so they can't be bound to actions.
+*/
+struct InputKey {
+	EventInputType type;
+	int32_t code;
+	uint16_t modifiers;
+	bool physical;
+
+	constexpr bool operator==(const InputKey &input_key) const {
+		return type == input_key.type && code == input_key.code && modifiers == input_key.modifiers && physical == input_key.physical;
+	}
+};
+
+struct InputKeyHash {
+	std::size_t operator()(const InputKey &input_key) const {
+		const uint64_t value = ((uint64_t)input_key.type << 49) | ((uint64_t)input_key.physical << 48) | ((uint64_t)input_key.modifiers << 32) | (uint32_t)input_key.code;
+		return std::hash<uint64_t>()(value);
+	}
+};
+
+}
+
+/**
+* @brief An action name resolved once by @b InputMap::get_action_handle, so the action can be looked up without hashing the name.
+* @details Stays valid as long as the InputMap exists, also when the action is cleared and created again.
+*/
+struct ActionHandle {
+	static constexpr natural INVALID_ID = ~natural(0);
+	natural id = INVALID_ID;
+
+	constexpr bool is_valid() const {
+		return id != INVALID_ID;
+	}
+
+	constexpr bool operator==(const ActionHandle &action_handle) const {
+		return id == action_handle.id;
+	}
+};
+
 class InputMap {
 
 public:
 	struct Action {
-		std::set<InputProxy, std::equal_to<InputProxy>> inputs;
+		std::vector<InputProxy> inputs;
+		ActionHandle handle;
 	};
 
+	/**
+	* @brief The maximum amount of InputKeys of one InputEvent.
+	*/
+	static constexpr natural MAX_INPUT_KEYS = 2;
+
 private:
 	std::unordered_map<String, Action> actions;
+	std::unordered_map<String, ActionHandle> action_handles;
+	std::vector<String> action_names;
+	std::vector<bool> created_actions;
+	std::vector<uint32_t> action_generations;
+	std::unordered_map<detail::InputKey, std::vector<ActionHandle>, detail::InputKeyHash> input_actions;
+
+	static natural _get_input_keys(const InputEvent *input_event, detail::InputKey *input_keys);
+	void _index_input(const ActionHandle action_handle, const InputProxy &input_proxy);
+	void _unindex_input(const Action &action, const InputProxy &input_proxy);
 	void _add_input_to_action(const String &action_name, const InputProxy &input_proxy);
 	void _remove_input_from_action(const String &action_name, const InputProxy &input_proxy);
 
@@ -60,16 +120,70 @@ public:
 	InputMap();
 	~InputMap();
 
-	void create_action(const String &action_name);
+	/**
+	* @brief Creates the action if it doesn't exist yet, and returns its handle.
+	*/
+	ActionHandle create_action(const String &action_name);
 	void add_key_to_action(const String &action_name, const std::shared_ptr<InputEvent> &input_event);
 	void remove_key_from_action(const String &action_name, const std::shared_ptr<InputEvent> &input_event);
 
 	bool has_action(const String &action_name) const;
 	void clear_action(const String &action_name);
 
+	bool has_action(const ActionHandle action_handle) const {
+		return action_handle.id < created_actions.size() && created_actions[action_handle.id];
+	}
+
+	/**
+	* @brief Returns how many times the action of @b action_handle was created, or 0 if the handle is invalid.
+	* @details Changes when a cleared action is created again, so state stored by action id can tell that it belongs to the old action.
+	*/
+	uint32_t get_action_generation(const ActionHandle action_handle) const {
+		return action_handle.id < action_generations.size() ? action_generations[action_handle.id] : 0;
+	}
+
+	/**
+	* @brief Returns the handle of the action named @b action_name, or an invalid handle if no action with that name was ever created.
+	*/
+	ActionHandle get_action_handle(const String &action_name) const;
+
+	/**
+	* @brief Returns the name of the action of @b action_handle, or an empty string if the handle is invalid.
+	*/
+	String get_action_name(const ActionHandle action_handle) const;
+
+	/**
+	* @brief Returns one more than the highest action id, the amount of states needed to store the state of every action by id.
+	*/
+	natural get_action_id_count() const {
+		return action_names.size();
+	}
+
 	std::vector<InputEvent> action_get_events(const String &action_name) const;
 	const std::unordered_map<String, Action> &get_actions() const;
 
+	/**
+	* @brief Calls @b function with the handle of every action that has an input matching @b input_event, each action once.
+	* @details Looks the actions up by the key code, scan code and modifiers of @b input_event, so it doesn't depend on the amount of actions.
+	*/
+	template<class F>
+	void for_each_event_action(const InputEvent *input_event, const F &function) const {
+		detail::InputKey input_keys[MAX_INPUT_KEYS];
+		const std::vector<ActionHandle> *key_actions[MAX_INPUT_KEYS] = {};
+		const natural input_key_count = _get_input_keys(input_event, input_keys);
+
+		for (natural i = 0; i < input_key_count; i++) {
+			const auto &iterator = input_actions.find(input_keys[i]);
+			if (iterator == input_actions.end())
+				continue;
+
+			key_actions[i] = &iterator->second;
+			for (const ActionHandle action_handle: iterator->second)
+				if (i == 0 || !key_actions[0] || std::find(key_actions[0]->begin(), key_actions[0]->end(), action_handle) == key_actions[0]->end())
+					function(action_handle);
+		}
+	}
+
 	bool event_get_action_state(const InputEvent *input_event, const String &action_name, bool *pressed = nullptr, float *strength = nullptr) const;
 	bool event_is_action(const InputEvent *input_event, const String &action_name) const;
 };
@@ -0,0 +1,163 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <input/input_recording.hpp>
+#include <input/event_input_type.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace Toof;
+
+static constexpr natural HEADER_SIZE = sizeof(uint32_t) * 3;
+static constexpr natural RECORD_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint16_t);
+
+template<class T>
+static void write_value(std::vector<uint8_t> &data, const T &value) {
+	const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&value);
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template<class T>
+static T read_value(const std::vector<uint8_t> &data, const natural position) {
+	T value;
+	std::memcpy(&value, data.data() + position, sizeof(T));
+	return value;
+}
+
+static uint16_t get_event_size(const SDL_Event *event) {
+	switch (get_event_type(event)) {
+		case EVENT_INPUT_TYPE_KEYBOARD:
+			return sizeof(SDL_KeyboardEvent);
+		case EVENT_INPUT_TYPE_MOUSE_MOTION:
+			return sizeof(SDL_MouseMotionEvent);
+		case EVENT_INPUT_TYPE_MOUSE_BUTTON:
+			return sizeof(SDL_MouseButtonEvent);
+		case EVENT_INPUT_TYPE_CONTROLLER_AXIS:
+			return sizeof(SDL_ControllerAxisEvent);
+		case EVENT_INPUT_TYPE_CONTROLLER_BUTTON:
+			return sizeof(SDL_ControllerButtonEvent);
+		default:
+			return sizeof(SDL_Event);
+	}
+}
+
+InputRecorder::InputRecorder(): data(),
+    event_count(0) {
+	clear();
+}
+
+void InputRecorder::record(const uint64_t frame, const SDL_Event *event) {
+	const uint16_t event_size = get_event_size(event);
+
+	write_value(data, frame);
+	write_value(data, event_size);
+	data.insert(data.end(), reinterpret_cast<const uint8_t*>(event), reinterpret_cast<const uint8_t*>(event) + event_size);
+	event_count++;
+}
+
+void InputRecorder::clear() {
+	data.clear();
+	write_value(data, MAGIC);
+	write_value(data, VERSION);
+	write_value(data, static_cast<uint32_t>(sizeof(SDL_Event)));
+	event_count = 0;
+}
+
+void InputRecorder::write(std::ostream &stream) const {
+	stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+bool InputRecorder::save(const std::filesystem::path &path) const {
+	std::ofstream file = std::ofstream(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	write(file);
+	return true;
+}
+
+InputPlayer::InputPlayer(): data(),
+    position(0) {
+}
+
+bool InputPlayer::set_data(const std::vector<uint8_t> &data) {
+	this->data.clear();
+	position = 0;
+
+	if (data.size() < HEADER_SIZE
+	    || read_value<uint32_t>(data, 0) != InputRecorder::MAGIC
+	    || read_value<uint32_t>(data, sizeof(uint32_t)) != InputRecorder::VERSION
+	    || read_value<uint32_t>(data, sizeof(uint32_t) * 2) != sizeof(SDL_Event))
+		return false;
+
+	this->data = data;
+	rewind();
+	return true;
+}
+
+bool InputPlayer::read(std::istream &stream) {
+	return set_data(std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()));
+}
+
+bool InputPlayer::load(const std::filesystem::path &path) {
+	std::ifstream file = std::ifstream(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	return read(file);
+}
+
+bool InputPlayer::next_event(const uint64_t frame, SDL_Event *event) {
+	if (is_finished() || read_value<uint64_t>(data, position) > frame)
+		return false;
+
+	const uint16_t event_size = read_value<uint16_t>(data, position + sizeof(uint64_t));
+	const natural event_position = position + RECORD_HEADER_SIZE;
+	if (event_size > sizeof(SDL_Event) || event_position + event_size > data.size()) {
+		position = data.size();
+		return false;
+	}
+
+	*event = SDL_Event();
+	std::memcpy(event, data.data() + event_position, event_size);
+	position = event_position + event_size;
+	return true;
+}
+
+void InputPlayer::rewind() {
+	position = data.empty() ? 0 : HEADER_SIZE;
+}
+
+bool InputPlayer::is_finished() const {
+	return position + RECORD_HEADER_SIZE > data.size();
+}
@@ -0,0 +1,113 @@
+/*  This file is part of the Toof Engine. */
+/** @file input_recording.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <SDL_events.h>
+
+namespace Toof {
+
+/**
+* @brief Records the SDL events processed by Input as a compact binary stream, each with the process frame it was processed in.
+* @details Each record holds the frame, the size of the event and the bytes of the event structure used by its type, which include its SDL timestamp.
+* The stream can be played back by an InputPlayer. It stores the events in the memory layout of the recording platform.
+* @see @b Input::set_recorder.
+*/
+class InputRecorder {
+	std::vector<uint8_t> data;
+	natural event_count;
+
+public:
+	static constexpr uint32_t MAGIC = 0x52495454; // "TTIR"
+	static constexpr uint32_t VERSION = 1;
+
+	InputRecorder();
+
+	/**
+	* @brief Appends @b event to the stream, to be played back before process frame @b frame.
+	*/
+	void record(const uint64_t frame, const SDL_Event *event);
+	void clear();
+
+	constexpr const std::vector<uint8_t> &get_data() const {
+		return data;
+	}
+
+	constexpr natural get_event_count() const {
+		return event_count;
+	}
+
+	void write(std::ostream &stream) const;
+
+	/**
+	* @brief Writes the stream to the file at @b path.
+	* @returns @b false if the file couldn't be opened.
+	*/
+	bool save(const std::filesystem::path &path) const;
+};
+
+/**
+* @brief Plays back a stream recorded by an InputRecorder, see @b SceneTree::set_input_player.
+*/
+class InputPlayer {
+	std::vector<uint8_t> data;
+	natural position;
+
+public:
+	InputPlayer();
+
+	/**
+	* @brief Replaces the stream by @b data and rewinds.
+	* @returns @b false and leaves the player empty if @b data isn't a stream written by a compatible InputRecorder.
+	*/
+	bool set_data(const std::vector<uint8_t> &data);
+	bool read(std::istream &stream);
+	bool load(const std::filesystem::path &path);
+
+	/**
+	* @brief Reads the next event into @b event if it was recorded for process frame @b frame or earlier.
+	* @returns @b false when the next event belongs to a later frame or the stream ended.
+	*/
+	bool next_event(const uint64_t frame, SDL_Event *event);
+
+	void rewind();
+	bool is_finished() const;
+};
+
+}
@@ -59,6 +59,7 @@ Camera2D::Camera2D(): offset(),
     fix_y(false),
     process_callback(CAMERA2D_PROCESS_RENDER),
     anchor_mode(CAMERA2D_ANCHOR_DRAG_CENTER) {
+	set_process_callback(process_callback);
 }
 
 Vector2f Camera2D::_get_target_scale() const {
@@ -178,6 +179,12 @@ Optional<const Transform2D&> Camera2D::get_camera_transform() const {
 	return NullOption;
 }
 
+void Camera2D::set_process_callback(const Camera2DProcessCallback process_callback) {
+	this->process_callback = process_callback;
+	set_process(process_callback == CAMERA2D_PROCESS_LOOP);
+	set_render_process(process_callback == CAMERA2D_PROCESS_RENDER);
+}
+
 void Camera2D::set_camera_transform(const Transform2D &transform) const {
 	_set_camera_transform(transform);
 }
@@ -274,9 +274,10 @@ public:
 		return fix_y;
 	}
 
-	constexpr void set_process_callback(const Camera2DProcessCallback process_callback) {
-		this->process_callback = process_callback;
-	}
+	/**
+	* @brief Sets whether the camera is updated in the process step or the render step.
+	*/
+	void set_process_callback(const Camera2DProcessCallback process_callback);
 
 	constexpr Camera2DProcessCallback get_process_callback() const {
 		return process_callback;
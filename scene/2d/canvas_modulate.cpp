@@ -0,0 +1,58 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/2d/canvas_modulate.hpp>
+
+using namespace Toof;
+
+CanvasModulate::CanvasModulate(): color(ColorV::WHITE()) {
+}
+
+void CanvasModulate::_notification(const int what) {
+	Node2D::_notification(what);
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	if (!rendering_server)
+		return;
+
+	if (what == NOTIFICATION_ENTER_TREE)
+		rendering_server.get_value()->set_canvas_modulate(color);
+	else if (what == NOTIFICATION_EXIT_TREE)
+		rendering_server.get_value()->set_canvas_modulate(ColorV::WHITE());
+}
+
+void CanvasModulate::set_color(const ColorV &new_color) {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	color = new_color;
+
+	if (rendering_server)
+		rendering_server.get_value()->set_canvas_modulate(color);
+}
@@ -0,0 +1,108 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/2d/light2d.hpp>
+#include <scene/resources/texture2d.hpp>
+
+using namespace Toof;
+
+Light2D::Light2D(): texture(nullptr),
+    color(ColorV::WHITE()),
+    offset(),
+    texture_scale(1.0) {
+	set_blend_mode(SDL_BLENDMODE_ADD);
+}
+
+void Light2D::_draw_light() const {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	if (!rendering_server)
+		return;
+
+	rendering_server.get_value()->canvas_item_clear(get_canvas_item());
+	if (!texture)
+		return;
+
+	const Vector2f scale = Vector2f(texture_scale, texture_scale);
+	const Vector2f texture_size = texture->get_size();
+	const Transform2D light_transform = Transform2D(Angle::ZERO_ROTATION(), offset - (texture_size / 2.0) * scale, scale);
+
+	texture->draw(texture->get_uid(), get_canvas_item(), SDL_FLIP_NONE, color, light_transform);
+}
+
+void Light2D::_notification(const int what) {
+	Node2D::_notification(what);
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	switch (what) {
+		case NOTIFICATION_ENTER_TREE:
+			if (rendering_server)
+				rendering_server.get_value()->canvas_item_set_light(get_canvas_item(), true);
+			if (texture)
+				texture->add_rendering_server_user(rendering_server.value_or(nullptr));
+			break;
+		case NOTIFICATION_EXIT_TREE:
+			if (texture)
+				texture->remove_rendering_server_user(rendering_server.value_or(nullptr));
+			break;
+		case NOTIFICATION_DRAW:
+			_draw_light();
+			break;
+		default:
+			break;
+	}
+}
+
+void Light2D::set_texture(const std::shared_ptr<Texture2D> &new_texture) {
+	if (texture && is_inside_tree())
+		texture->remove_rendering_server_user(get_rendering_server().value_or(nullptr));
+
+	texture = new_texture;
+
+	if (texture && is_inside_tree())
+		texture->add_rendering_server_user(get_rendering_server().value_or(nullptr));
+
+	queue_redraw();
+}
+
+void Light2D::set_color(const ColorV &new_color) {
+	color = new_color;
+	queue_redraw();
+}
+
+void Light2D::set_offset(const Vector2f &new_offset) {
+	offset = new_offset;
+	queue_redraw();
+}
+
+void Light2D::set_texture_scale(const real new_texture_scale) {
+	texture_scale = new_texture_scale;
+	queue_redraw();
+}
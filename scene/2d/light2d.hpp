@@ -0,0 +1,97 @@
+/*  This file is part of the Toof Engine. */
+/** @file light2d.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <scene/2d/node2d.hpp>
+
+namespace Toof {
+
+class Texture2D;
+
+/**
+* @brief Lights up the area covered by its texture.
+* @details Lights are drawn additively into the light buffer of the RenderingServer, which is then multiplied over the canvas.
+* Without lights the canvas is only modulated by the color of the CanvasModulate.
+* @see @b RenderingServer::set_light_buffer_scale, @b CanvasModulate.
+*/
+class Light2D : public Node2D {
+private:
+	std::shared_ptr<Texture2D> texture;
+	ColorV color;
+	Vector2f offset;
+	real texture_scale;
+
+	void _draw_light() const;
+	void _notification(const int what) override;
+public:
+	Light2D();
+	~Light2D() = default;
+
+	/**
+	* @brief Sets the texture used as the shape of the light, usually a radial gradient.
+	*/
+	void set_texture(const std::shared_ptr<Texture2D> &new_texture);
+
+	constexpr const std::shared_ptr<Texture2D> &get_texture() const {
+		return texture;
+	}
+
+	/**
+	* @brief Sets the color of the light, which tints the texture.
+	*/
+	void set_color(const ColorV &new_color);
+
+	constexpr const ColorV &get_color() const {
+		return color;
+	}
+
+	/**
+	* @brief Sets the offset of the texture, relative to the center of the light.
+	*/
+	void set_offset(const Vector2f &new_offset);
+
+	constexpr const Vector2f &get_offset() const {
+		return offset;
+	}
+
+	/**
+	* @brief Sets the scale of the texture, changing the size of the lit area.
+	*/
+	void set_texture_scale(const real new_texture_scale);
+
+	constexpr real get_texture_scale() const {
+		return texture_scale;
+	}
+};
+
+}
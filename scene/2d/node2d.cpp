@@ -98,3 +98,59 @@ void Node2D::set_global_transform(const Transform2D &new_global_transform) {
 	transform.scale = -(global_transform.scale - new_transform.scale);
 	queue_redraw();
 }
+
+void Node2D::set_physics_interpolation_enabled(const bool enabled) {
+	physics_interpolation_enabled = enabled;
+	reset_physics_interpolation();
+
+	// Processing is left enabled when interpolation is disabled, as the node may still need it for itself.
+	if (enabled) {
+		set_physics_process(true);
+		set_render_process(true);
+	}
+	queue_redraw();
+}
+
+void Node2D::reset_physics_interpolation() {
+	previous_physics_transform = transform;
+	current_physics_transform = transform;
+}
+
+void Node2D::_update_physics_interpolation() {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	if (rendering_server) {
+		const Transform2D interpolated_transform = previous_physics_transform.interpolate_with(current_physics_transform, get_tree()->get_physics_interpolation_fraction());
+		rendering_server.get_value()->canvas_item_set_transform(get_canvas_item(), interpolated_transform);
+	}
+}
+
+void Node2D::_notification(const int what) {
+	CanvasNode::_notification(what);
+
+	if (!physics_interpolation_enabled)
+		return;
+
+	// A reused node would otherwise be interpolated from the transform it had when it was returned to its pool.
+	if (physics_interpolation_reset_queued && (what == NOTIFICATION_POST_PHYSICS_PROCESS || what == NOTIFICATION_RENDER)) {
+		reset_physics_interpolation();
+		physics_interpolation_reset_queued = false;
+	}
+
+	switch (what) {
+		case NOTIFICATION_ENTER_TREE:
+		case NOTIFICATION_TAKEN_FROM_POOL:
+			reset_physics_interpolation();
+			physics_interpolation_reset_queued = true;
+			break;
+		case NOTIFICATION_POST_PHYSICS_PROCESS:
+			previous_physics_transform = current_physics_transform;
+			current_physics_transform = transform;
+			break;
+		case NOTIFICATION_RENDER:
+			_update_physics_interpolation();
+			break;
+		default:
+			break;
+	}
+}
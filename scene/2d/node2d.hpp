@@ -51,6 +51,14 @@ public:
 	};
 private:
 	Transform2D transform = Transform2D::IDENTITY;
+	Transform2D previous_physics_transform = Transform2D::IDENTITY;
+	Transform2D current_physics_transform = Transform2D::IDENTITY;
+	bool physics_interpolation_enabled = false;
+	bool physics_interpolation_reset_queued = false;
+
+	void _update_physics_interpolation();
+protected:
+	void _notification(const int what) override;
 public:
 	Node2D() = default;
 	~Node2D() = default;
@@ -135,6 +143,24 @@ public:
 	* @brief Sets the global transform of this Node2D to @b new_global_transform.
 	*/
 	void set_global_transform(const Transform2D &new_global_transform);
+
+	/**
+	* @brief If true, the rendered transform of this Node2D is interpolated between its transforms at the two last physics steps.
+	* @details Use this for nodes moved in _physics_process, so they move smoothly when the render rate is higher than the physics rate.
+	* The rendered transform lags up to one physics step behind.
+	*/
+	void set_physics_interpolation_enabled(const bool enabled);
+
+	constexpr bool is_physics_interpolation_enabled() const {
+		return physics_interpolation_enabled;
+	}
+
+	/**
+	* @brief Makes the rendered transform jump to the current transform, instead of interpolating from the previous physics step.
+	* @details Call this after teleporting the Node2D. Done automatically when the node enters the tree or is taken from its NodePool,
+	* using the transform it has at its next physics step or render, so it can still be moved right after.
+	*/
+	void reset_physics_interpolation();
 };
 
 }
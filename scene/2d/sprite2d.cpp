@@ -79,17 +79,21 @@ void Sprite2D::_notification(const int what) {
 		_draw_texture();
 
 	if (what == NOTIFICATION_ENTER_TREE && texture)
-		texture->set_rendering_server(get_rendering_server().get_value());
+		texture->add_rendering_server_user(get_rendering_server().value_or(nullptr));
 
+	// Other sprites or a SubViewport can still be drawing the texture, it is unloaded when its last user leaves.
 	if (what == NOTIFICATION_EXIT_TREE && texture)
-		texture->set_rendering_server(nullptr);
+		texture->remove_rendering_server_user(get_rendering_server().value_or(nullptr));
 }
 
 void Sprite2D::set_texture(const std::shared_ptr<Texture2D> &new_texture) {
+	if (texture && is_inside_tree())
+		texture->remove_rendering_server_user(get_rendering_server().value_or(nullptr));
+
 	texture = new_texture;
 
 	if (texture && is_inside_tree())
-		texture->set_rendering_server(get_rendering_server().get_value());
+		texture->add_rendering_server_user(get_rendering_server().value_or(nullptr));
 
 	texture_changed();
 	queue_redraw();
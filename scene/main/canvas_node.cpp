@@ -44,7 +44,7 @@ void CanvasNode::_update() {
 		rendering_server.get_value()->canvas_item_set_modulate(canvas_item, modulation);
 		rendering_server.get_value()->canvas_item_set_blend_mode(canvas_item, blend_mode);
 		rendering_server.get_value()->canvas_item_set_scale_mode(canvas_item, scale_mode);
-		rendering_server.get_value()->canvas_item_set_visible(canvas_item, visible);
+		rendering_server.get_value()->canvas_item_set_visible(canvas_item, visible && !is_in_pool());
 		rendering_server.get_value()->canvas_item_set_zindex(canvas_item, zindex);
 		rendering_server.get_value()->canvas_item_set_zindex_relative(canvas_item, zindex_relative);
 	}
@@ -64,8 +64,15 @@ void CanvasNode::_on_parent_changed(Node *parent) {
 void CanvasNode::_on_tree_enter() {
 	Optional<RenderingServer*> rendering_server = get_rendering_server();
 
-	if (rendering_server)
+	if (!rendering_server)
+		return;
+
+	// PackedScene creates the canvas items of a whole scene at once before it enters the tree.
+	if (!canvas_item)
 		canvas_item = rendering_server.get_value()->create_canvas_item();
+
+	// Children added before this node entered the tree were parented while there was no canvas item.
+	_on_parent_changed(get_parent());
 }
 
 void CanvasNode::_on_tree_exit() {
@@ -73,10 +80,13 @@ void CanvasNode::_on_tree_exit() {
 
 	if (rendering_server)
 		rendering_server.get_value()->remove_uid(canvas_item);
+
+	canvas_item = 0;
 }
 
 Optional<RenderingServer*> CanvasNode::get_rendering_server() const {
-	if (is_inside_tree())
+	// A headless SceneTree has no RenderingServer.
+	if (is_inside_tree() && get_tree()->get_rendering_server())
 		return get_tree()->get_rendering_server().get();
 	return NullOption;
 }
@@ -97,6 +107,12 @@ void CanvasNode::_notification(int what) {
 		case NOTIFICATION_PARENTED:
 			_on_parent_changed(get_parent());
 			break;
+		// The canvas item is kept while the node is in its pool, so it doesn't have to be created again.
+		case NOTIFICATION_RETURNED_TO_POOL:
+		case NOTIFICATION_TAKEN_FROM_POOL:
+			if (get_rendering_server())
+				get_rendering_server().get_value()->canvas_item_set_visible(canvas_item, visible && !is_in_pool());
+			break;
 		default:
 			break;
 	}
@@ -119,9 +135,12 @@ void CanvasNode::queue_redraw() {
 	if (!is_inside_tree() || update_queued)
 		return;
 
-	SceneTree *tree = get_tree();
-	tree->deferred_signals.connect(std::bind(&CanvasNode::_update, this));
-	tree->deferred_signals.connect(std::bind(&Node::notification, this, NOTIFICATION_DRAW));
+	// Deferred through the thread group of the node, so nodes processed on other threads can be redrawn as well.
+	update_queued = true;
+	call_deferred([this]() {
+		_update();
+		notification(NOTIFICATION_DRAW);
+	});
 }
 
 Transform2D CanvasNode::get_transform() const {
@@ -43,6 +43,7 @@
 namespace Toof {
 
 class RenderingServer;
+class PackedScene;
 
 template<class>
 class Rect2;
@@ -97,6 +98,8 @@ private:
 	void _on_parent_changed(Node *parent);
 	void _on_tree_enter();
 	void _on_tree_exit();
+
+	friend PackedScene;
 protected:
 	/**
 	* @returns the RenderingServer from the tree or nullptr if the Node is not inside a.
@@ -31,23 +31,59 @@
 */
 #include <scene/main/node.hpp>
 #include <scene/main/scene_tree.hpp>
+#include <scene/main/node_pool.hpp>
+#include <scene/main/node_path.hpp>
+#include <scene/main/node_timing.hpp>
+#include <core/os/profiler.hpp>
+#include <core/os/thread_pool.hpp>
 #include <input/input.hpp>
 
 #include <SDL_events.h>
 
+#include <algorithm>
+#include <cassert>
+
 using namespace Toof;
 
+std::atomic<uint64_t> Node::tree_structure_version = 0;
+
 Node::Node(): children(),
+    children_by_name(),
+    duplicate_child_names(0),
     tree(nullptr),
     parent(nullptr),
+    pool(nullptr),
+    pool_index(0),
+    timings(),
     name("Node"),
+    interned_name("Node"),
+    process_priority(0),
+    tree_order(0),
+    structure_version(++tree_structure_version),
+    process_list_indices(),
+    index(0),
+    process_thread_group(0),
     is_ready(false),
-	is_deletion_queued(false) {
+	is_deletion_queued(false),
+    in_pool(false),
+    processing(false),
+    physics_processing(false),
+    render_processing(false),
+    processing_input(false) {
+	process_list_indices.fill(detail::ProcessList::INVALID_INDEX);
 }
 
 Node::~Node() {
 	notification(NOTIFICATION_PREDELETE);
 
+	if (tree && !in_pool) {
+		_unregister_process_callbacks();
+		_unregister_groups();
+	}
+
+	if (pool)
+		pool->_on_node_deleted(this);
+
 	if (parent)
 		parent->remove_child(this);
 
@@ -56,42 +92,268 @@ Node::~Node() {
 
 void Node::_reset_tree() {
 	if (tree)
-		propagate_notification(NOTIFICATION_EXIT_TREE);
-
-	tree = nullptr;
+		_set_tree_recursive(nullptr);
 }
 
 void Node::_reset_parent(const bool erase_as_child) {
 	if (parent && erase_as_child)
-		parent->children.erase(this);
+		parent->_remove_child_at(index);
 
 	parent = nullptr;
+	index = 0;
+	_update_structure_version();
 	notification(NOTIFICATION_PARENTED);
 }
 
-void Node::_add_child_nocheck(Node *new_child) {
-	children.insert(new_child);
+void Node::_remove_child_at(const natural child_index) {
+	Node *child = children[child_index];
+
+	children.erase(children.begin() + child_index);
+	_update_child_indices(child_index, children.size());
+	_unindex_child_name(child);
+	_update_structure_version();
+}
+
+void Node::_index_child_name(Node *child) {
+	// Only the first child with a name is indexed, the others are counted so removing a unique name doesn't look for them.
+	if (!children_by_name.try_emplace(child->interned_name, child).second)
+		duplicate_child_names++;
+}
+
+void Node::_unindex_child_name(Node *child) {
+	const auto iterator = children_by_name.find(child->interned_name);
+	if (iterator == children_by_name.end())
+		return;
+
+	if (iterator->second != child) {
+		duplicate_child_names--;
+		return;
+	}
+
+	children_by_name.erase(iterator);
+	if (!duplicate_child_names)
+		return;
+
+	// The next child with the same name takes its place. Usually it comes after the cached index, unless children were moved.
+	for (natural i = 0; i < children.size(); i++) {
+		Node *sibling = children[(child->index + i) % children.size()];
+		if (sibling != child && sibling->interned_name == child->interned_name) {
+			children_by_name.insert({sibling->interned_name, sibling});
+			duplicate_child_names--;
+			return;
+		}
+	}
+}
+
+void Node::_update_child_indices(const natural from, const natural to) {
+	for (natural i = from; i < to; i++)
+		children[i]->index = i;
+}
+
+void Node::_link_child(Node *new_child) {
+	new_child->index = children.size();
+	children.push_back(new_child);
 	new_child->parent = this;
+	_index_child_name(new_child);
+	_update_structure_version();
+	new_child->_update_structure_version();
+}
 
-	if (tree)
+void Node::_add_child_nocheck(Node *new_child) {
+	_link_child(new_child);
+
+	if (tree) {
 		new_child->set_tree(tree);
+		new_child->_check_tree_order();
+	}
 
 	new_child->notification(NOTIFICATION_PARENTED);
 }
 
+void Node::_attach_tree(SceneTree *tree) {
+	this->tree = tree;
+	tree_order = tree->tree_order_counter++;
+	tree->_create_process_group(process_thread_group);
+
+	if (!in_pool) {
+		_register_process_callbacks();
+		_register_groups();
+	}
+}
+
+void Node::_notify_ready() {
+	if (!is_ready) {
+		notification(NOTIFICATION_READY);
+		is_ready = true;
+	}
+}
+
 void Node::_set_tree(SceneTree *tree) {
 	SceneTree *old_tree = this->tree;
-	this->tree = tree;
 
 	if (!old_tree && tree) {
+		_attach_tree(tree);
 		notification(NOTIFICATION_ENTER_TREE);
-
-		if (!is_ready) {
-			notification(NOTIFICATION_READY);
-			is_ready = true;
-		}
-	} else if (old_tree && !tree)
+		_notify_ready();
+	} else if (old_tree && !tree) {
+		// The node is still inside the tree while it receives the notification, so it can clean up.
 		notification(NOTIFICATION_EXIT_TREE);
+		if (!in_pool) {
+			_unregister_process_callbacks();
+			_unregister_groups();
+		}
+		this->tree = nullptr;
+	}
+}
+
+detail::ProcessList &Node::_get_process_list(const detail::ProcessCallback callback) const {
+	const bool threaded = callback == detail::PROCESS_CALLBACK_PROCESS || callback == detail::PROCESS_CALLBACK_PHYSICS_PROCESS;
+	return tree->_get_process_group(threaded ? process_thread_group : 0).process_lists[callback];
+}
+
+void Node::_set_process_callback(bool &callback_enabled, const detail::ProcessCallback callback, const bool enabled) {
+	if (callback_enabled == enabled)
+		return;
+
+	callback_enabled = enabled;
+	if (!tree || in_pool)
+		return;
+
+	if (enabled)
+		_get_process_list(callback).add(this);
+	else
+		_get_process_list(callback).remove(this);
+}
+
+void Node::_register_process_callbacks() {
+	if (processing)
+		_get_process_list(detail::PROCESS_CALLBACK_PROCESS).add(this);
+	if (physics_processing)
+		_get_process_list(detail::PROCESS_CALLBACK_PHYSICS_PROCESS).add(this);
+	if (render_processing)
+		_get_process_list(detail::PROCESS_CALLBACK_RENDER).add(this);
+	if (processing_input)
+		_get_process_list(detail::PROCESS_CALLBACK_INPUT).add(this);
+}
+
+void Node::_unregister_process_callbacks() {
+	if (processing)
+		_get_process_list(detail::PROCESS_CALLBACK_PROCESS).remove(this);
+	if (physics_processing)
+		_get_process_list(detail::PROCESS_CALLBACK_PHYSICS_PROCESS).remove(this);
+	if (render_processing)
+		_get_process_list(detail::PROCESS_CALLBACK_RENDER).remove(this);
+	if (processing_input)
+		_get_process_list(detail::PROCESS_CALLBACK_INPUT).remove(this);
+}
+
+void Node::set_process(const bool enabled) {
+	_set_process_callback(processing, detail::PROCESS_CALLBACK_PROCESS, enabled);
+}
+
+void Node::set_physics_process(const bool enabled) {
+	_set_process_callback(physics_processing, detail::PROCESS_CALLBACK_PHYSICS_PROCESS, enabled);
+}
+
+void Node::set_render_process(const bool enabled) {
+	_set_process_callback(render_processing, detail::PROCESS_CALLBACK_RENDER, enabled);
+}
+
+void Node::set_process_input(const bool enabled) {
+	_set_process_callback(processing_input, detail::PROCESS_CALLBACK_INPUT, enabled);
+}
+
+void Node::set_process_priority(const int priority) {
+	process_priority = priority;
+
+	if (tree && !in_pool)
+		for (const detail::ProcessCallback callback: {detail::PROCESS_CALLBACK_PROCESS, detail::PROCESS_CALLBACK_PHYSICS_PROCESS, detail::PROCESS_CALLBACK_RENDER, detail::PROCESS_CALLBACK_INPUT})
+			_get_process_list(callback).mark_unsorted();
+}
+
+void Node::set_process_thread_group(const natural thread_group) {
+	if (process_thread_group == thread_group)
+		return;
+
+	if (tree && !in_pool)
+		_unregister_process_callbacks();
+
+	process_thread_group = thread_group;
+
+	if (tree)
+		tree->_create_process_group(thread_group);
+
+	if (tree && !in_pool)
+		_register_process_callbacks();
+}
+
+void Node::_register_groups() {
+	for (auto &[group, group_index]: groups)
+		tree->_get_group(group).add(this);
+}
+
+void Node::_unregister_groups() {
+	for (auto &[group, group_index]: groups)
+		tree->_get_group(group).remove(this, group_index);
+}
+
+void Node::add_to_group(const StringName &group) {
+	if (!groups.try_emplace(group, 0).second)
+		return;
+
+	if (tree && !in_pool)
+		tree->_get_group(group).add(this);
+}
+
+void Node::remove_from_group(const StringName &group) {
+	const auto iterator = groups.find(group);
+	if (iterator == groups.end())
+		return;
+
+	if (tree && !in_pool)
+		tree->_get_group(group).remove(this, iterator->second);
+
+	groups.erase(iterator);
+}
+
+bool Node::is_in_group(const StringName &group) const {
+	return groups.count(group);
+}
+
+std::vector<StringName> Node::get_groups() const {
+	std::vector<StringName> group_names;
+	group_names.reserve(groups.size());
+
+	for (const auto &[group, group_index]: groups)
+		group_names.push_back(group);
+
+	return group_names;
+}
+
+void Node::_return_to_pool() {
+	if (tree) {
+		_unregister_process_callbacks();
+		_unregister_groups();
+	}
+
+	in_pool = true;
+	is_deletion_queued = false;
+	notification(NOTIFICATION_RETURNED_TO_POOL);
+}
+
+void Node::_take_from_pool() {
+	in_pool = false;
+
+	if (tree) {
+		_register_process_callbacks();
+		_register_groups();
+	}
+
+	notification(NOTIFICATION_TAKEN_FROM_POOL);
+}
+
+CallQueue *Node::_get_deferred_call_queue() const {
+	return tree ? &tree->_get_process_group(process_thread_group).deferred_calls : nullptr;
 }
 
 void Node::_set_tree_recursive(SceneTree *tree) {
@@ -101,6 +363,30 @@ void Node::_set_tree_recursive(SceneTree *tree) {
 		child->_set_tree_recursive(tree);
 }
 
+void Node::_update_tree_order(uint64_t &order) {
+	tree_order = order++;
+
+	for (Node *child: children)
+		child->_update_tree_order(order);
+}
+
+void Node::_update_structure_version() {
+	// Children, the name index and the interned names aren't synchronized, so only the main thread may change them.
+	// Thread groups and parallel group calls can defer such changes with call_deferred.
+	assert(!ThreadPool::is_running_job() && "Nodes can only be added, removed or renamed on the main thread.");
+	structure_version = ++tree_structure_version;
+}
+
+void Node::_check_tree_order() {
+	// Entering the tree gives the next order, which only matches the position of nodes added at the end of the tree.
+	for (const Node *node = this; node->parent; node = node->parent) {
+		if (node->index + 1 != node->parent->children.size()) {
+			tree->tree_order_dirty = true;
+			return;
+		}
+	}
+}
+
 void Node::_ready() {
 }
 
@@ -113,21 +399,60 @@ void Node::_physics_process(const double) {
 void Node::_render(double) {
 }
 
-void Node::_event(const std::shared_ptr<InputEvent>&) {
+void Node::_event(const InputEventRef) {
 }
 
 void Node::_notification(const int) {
 }
 
 void Node::queue_free() {
-	if (is_deletion_queued || !tree)
+	if (is_deletion_queued || in_pool || !tree)
 		return;
 
-	tree->queue_free(this);
 	is_deletion_queued = true;
+
+	// Queued through the deferred calls, so nodes in thread groups can free themselves as well.
+	call_deferred([tree = tree, this]() {
+		tree->queue_free(this);
+	});
+}
+
+detail::ProcessCallback Node::_get_timed_callback(const int what) {
+	switch (what) {
+		case NOTIFICATION_PROCESS:
+			return detail::PROCESS_CALLBACK_PROCESS;
+		case NOTIFICATION_PHYSICS_PROCESS:
+		case NOTIFICATION_POST_PHYSICS_PROCESS:
+			return detail::PROCESS_CALLBACK_PHYSICS_PROCESS;
+		case NOTIFICATION_RENDER:
+			return detail::PROCESS_CALLBACK_RENDER;
+		default:
+			return detail::PROCESS_CALLBACK_MAX;
+	}
+}
+
+void Node::_add_callback_time(const detail::ProcessCallback callback, const int64_t time) {
+	// A node is only processed by one thread at a time, so the timings don't need to be synchronized.
+	if (!timings)
+		timings = std::make_unique<detail::NodeTimings>();
+
+	timings->step_time[callback] += time;
 }
 
 void Node::notification(const int what) {
+	const detail::ProcessCallback timed_callback = tree && tree->node_timing_enabled ? _get_timed_callback(what) : detail::PROCESS_CALLBACK_MAX;
+
+	if (timed_callback == detail::PROCESS_CALLBACK_MAX) {
+		_notify(what);
+		return;
+	}
+
+	const int64_t start = Profiler::get_time_now();
+	_notify(what);
+	_add_callback_time(timed_callback, Profiler::get_time_now() - start);
+}
+
+void Node::_notify(const int what) {
 	_notification(what);
 	if (what == NOTIFICATION_EXIT_TREE)
 		tree_exiting();
@@ -185,14 +510,67 @@ void Node::add_child(Node *child) {
 	if (!child || child->parent == this)
 		return;
 
+	if (child->parent)
+		child->parent->remove_child(child);
+
 	_add_child_nocheck(child);
 }
 
 void Node::set_name(const String &new_name) {
+	if (parent)
+		parent->_unindex_child_name(this);
+
 	name = new_name;
+	interned_name = StringName(name);
+
+	if (parent) {
+		parent->_index_child_name(this);
+		parent->_update_structure_version();
+	}
+
+	_update_structure_version();
 	renamed(name);
 }
 
+Node *Node::find_child(const StringName &child_name, const bool recursive) const {
+	const auto iterator = children_by_name.find(child_name);
+	if (iterator != children_by_name.end())
+		return iterator->second;
+
+	if (!recursive)
+		return nullptr;
+
+	for (const Node *child: children) {
+		Node *found_child = child->find_child(child_name, true);
+		if (found_child)
+			return found_child;
+	}
+
+	return nullptr;
+}
+
+Node *Node::get_node(const NodePath &path) const {
+	return path.resolve(this);
+}
+
+void Node::move_child(Node *child, const natural to_index) {
+	if (!child || child->parent != this)
+		return;
+
+	const natural from_index = child->index;
+	const natural new_index = std::min<natural>(to_index, children.size() - 1);
+
+	if (from_index < new_index)
+		std::rotate(children.begin() + from_index, children.begin() + from_index + 1, children.begin() + new_index + 1);
+	else if (from_index > new_index)
+		std::rotate(children.begin() + new_index, children.begin() + from_index, children.begin() + from_index + 1);
+
+	_update_child_indices(std::min(from_index, new_index), std::max(from_index, new_index) + 1);
+
+	if (tree && from_index != new_index)
+		tree->tree_order_dirty = true;
+}
+
 void Node::remove_child(Node* node) {
 	if (node->parent != this)
 		return;
@@ -225,18 +603,38 @@ const std::unique_ptr<SDL_Event> &Node::get_event() const {
 	return *(i);
 }
 
-void Node::propagate_input_event(const std::shared_ptr<InputEvent> &input_event) {
+void Node::_input_event(const InputEventRef input_event) {
 	notification(NOTIFICATION_EVENT);
 	_event(input_event);
+}
+
+bool Node::_propagate_input_event(const InputEventRef input_event) {
+	for (natural i = children.size(); i > 0; i--)
+		if (children[i - 1]->_propagate_input_event(input_event))
+			return true;
+
+	if (processing_input)
+		_input_event(input_event);
 
-	for (Node *node: children)
-		node->propagate_input_event(input_event);
+	return tree && tree->is_input_handled();
+}
+
+void Node::propagate_input_event(const InputEventRef input_event) {
+	if (tree)
+		tree->input_handled = false;
+
+	_propagate_input_event(input_event);
 }
 
 void Node::remove_children() {
-	for (Node *node: children) {
+	children_t removed_children;
+	removed_children.swap(children);
+	children_by_name.clear();
+	duplicate_child_names = 0;
+	_update_structure_version();
+
+	for (Node *node: removed_children) {
 		node->_reset_parent(false);
 		node->_reset_tree();
 	}
-	children.clear();
 }
@@ -33,18 +33,33 @@
 #pragma once
 
 #include <core/string/string_def.hpp>
+#include <core/string/string_name.hpp>
 #include <core/memory/signal.hpp>
+#include <core/math/math_defs.hpp>
+#include <core/memory/call_queue.hpp>
+#include <scene/main/process_list.hpp>
 
+#include <array>
+#include <atomic>
 #include <memory>
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include <SDL_events.h>
 
 namespace Toof {
 
 class SceneTree;
-class InputEvent;
+class InputEventRef;
 class Input;
+class NodePool;
+class NodePath;
+class PackedScene;
+
+namespace detail {
+class NodeGroup;
+struct NodeTimings;
+}
 
 /**
 * @brief Base class for all scene objects.
@@ -53,7 +68,7 @@ class Input;
 
 class Node {
 
-using children_t = std::unordered_set<Node*>;
+using children_t = std::vector<Node*>;
 
 public:
 	enum ProcessMode {
@@ -158,20 +173,75 @@ public:
 		* @brief Notification received from the SceneTree's crash handler when the program is about to crash. Implemented on desktop platforms.
 		*/
 		NOTIFICATION_CRASH,
+
+		/**
+		* @brief Notification received after each physics step, once the PhysicsServer2D has been ticked.
+		*/
+		NOTIFICATION_POST_PHYSICS_PROCESS,
+
+		/**
+		* @brief Notification received when the node is returned to its NodePool, instead of being deleted. @see @b NodePool.
+		*/
+		NOTIFICATION_RETURNED_TO_POOL,
+
+		/**
+		* @brief Notification received when the node is taken from its NodePool to be reused. @see @b NodePool.
+		*/
+		NOTIFICATION_TAKEN_FROM_POOL,
 	};
 
 private:
 	children_t children;
+	std::unordered_map<StringName, Node*> children_by_name;
+	natural duplicate_child_names;
+	std::unordered_map<StringName, natural> groups;
 	SceneTree *tree;
 	Node *parent;
+	NodePool *pool;
+	natural pool_index;
+	std::unique_ptr<detail::NodeTimings> timings;
 	String name;
-	bool is_ready, is_deletion_queued;
-
+	StringName interned_name;
+	int process_priority;
+	uint64_t tree_order;
+	uint64_t structure_version;
+	std::array<natural, detail::PROCESS_CALLBACK_MAX> process_list_indices;
+	natural index;
+	natural process_thread_group;
+	bool is_ready, is_deletion_queued, in_pool;
+
+	static std::atomic<uint64_t> tree_structure_version;
+	bool processing, physics_processing, render_processing, processing_input;
+
+	static detail::ProcessCallback _get_timed_callback(const int what);
+	void _notify(const int what);
+	void _add_callback_time(const detail::ProcessCallback callback, const int64_t time);
+	detail::ProcessList &_get_process_list(const detail::ProcessCallback callback) const;
+	void _set_process_callback(bool &callback_enabled, const detail::ProcessCallback callback, const bool enabled);
+	void _register_process_callbacks();
+	void _unregister_process_callbacks();
+	void _input_event(const InputEventRef input_event);
+	bool _propagate_input_event(const InputEventRef input_event);
+	CallQueue *_get_deferred_call_queue() const;
+	void _register_groups();
+	void _unregister_groups();
+	void _return_to_pool();
+	void _take_from_pool();
 	void _reset_tree();
 	void _reset_parent(const bool erase_as_child = true);
+	void _remove_child_at(const natural child_index);
+	void _index_child_name(Node *child);
+	void _unindex_child_name(Node *child);
+	void _update_child_indices(const natural from, const natural to);
+	void _link_child(Node *node);
 	void _add_child_nocheck(Node *node);
+	void _attach_tree(SceneTree *tree);
+	void _notify_ready();
 	void _set_tree(SceneTree *tree);
 	void _set_tree_recursive(SceneTree *tree);
+	void _update_tree_order(uint64_t &order);
+	void _update_structure_version();
+	void _check_tree_order();
 
 protected:
 	/**
@@ -184,8 +254,9 @@ protected:
 	* @brief Called each time an "event" happens.
 	* @details This can be keyboard input, mouse movement, window size changing, etc.
 	* Events are instantly processed from when they happen.
+	* @b event stays valid until the end of the next process step, use @b InputEventRef::retain to keep it for longer.
 	*/
-	virtual void _event(const std::shared_ptr<InputEvent> &event);
+	virtual void _event(const InputEventRef event);
 
 	/**
 	* @brief Called in the render step of the tree.
@@ -216,6 +287,11 @@ protected:
 	*/
 	virtual void _ready();
 
+	friend SceneTree;
+	friend NodePool;
+	friend detail::NodeGroup;
+	friend detail::ProcessList;
+	friend PackedScene;
 public:
 	Node();
 
@@ -253,9 +329,10 @@ public:
 	const std::unique_ptr<SDL_Event> &get_event() const;
 
 	/**
-	* @brief Propagates the InputEvent to all descendants.
+	* @brief Propagates the InputEvent to this node and all descendants that process input, in reverse tree order.
+	* @details The propagation stops when a node calls @b SceneTree::set_input_as_handled.
 	*/
-	void propagate_input_event(const std::shared_ptr<InputEvent> &input_event);
+	void propagate_input_event(const InputEventRef input_event);
 
 	/**
 	* @brief Returns the time between the previous render step and the current render step.
@@ -286,12 +363,130 @@ public:
 	*/
 	void propagate_notification(const int what);
 
+	/**
+	* @brief If true, the node receives @b NOTIFICATION_PROCESS and @b _process each process step.
+	* @details Only nodes with processing enabled are visited by the SceneTree each step, nodes that don't process cost nothing.
+	* Nodes are processed in order of their process priority, and then in the order they entered the tree.
+	*/
+	void set_process(const bool enabled);
+
+	constexpr bool is_processing() const {
+		return processing;
+	}
+
+	/**
+	* @brief If true, the node receives @b NOTIFICATION_PHYSICS_PROCESS, @b _physics_process and @b NOTIFICATION_POST_PHYSICS_PROCESS each physics step.
+	* @see @b set_process.
+	*/
+	void set_physics_process(const bool enabled);
+
+	constexpr bool is_physics_processing() const {
+		return physics_processing;
+	}
+
+	/**
+	* @brief If true, the node receives @b NOTIFICATION_RENDER and @b _render each render step.
+	* @see @b set_process.
+	*/
+	void set_render_process(const bool enabled);
+
+	constexpr bool is_render_processing() const {
+		return render_processing;
+	}
+
+	/**
+	* @brief If true, the node receives @b NOTIFICATION_EVENT and @b _event for each input event.
+	* @see @b set_process.
+	*/
+	void set_process_input(const bool enabled);
+
+	constexpr bool is_processing_input() const {
+		return processing_input;
+	}
+
+	/**
+	* @brief Sets the order in which the node is called for all processing callbacks. Lower values are called first.
+	* @details Nodes with the same priority are called in the order they entered the tree.
+	*/
+	void set_process_priority(const int priority);
+
+	constexpr int get_process_priority() const {
+		return process_priority;
+	}
+
+	/**
+	* @brief Sets the thread group the process and physics process callbacks of this node are called from.
+	* @details Group 0 is the main thread and the default. The nodes of every other group are processed in order on one thread,
+	* while the groups themselves are processed in parallel on the thread pool of the SceneTree.
+	* Nodes in a thread group should only change their own state and the state of nodes in the same group.
+	* Anything else, like adding children or changing nodes of other groups, should be done with @b call_deferred.
+	* Render and input callbacks are always called from the main thread. Should only be called from the main thread.
+	*/
+	void set_process_thread_group(const natural thread_group);
+
+	constexpr natural get_process_thread_group() const {
+		return process_thread_group;
+	}
+
+	/**
+	* @brief Calls @b function on the main thread after the current process or physics step.
+	* @details Deferred calls of the thread groups are made in order of the group, so the result is the same regardless of which thread finished first.
+	* Small callables, like a lambda capturing a few pointers, are queued without allocating. Does nothing if the node is not inside the tree.
+	* @see @b CallQueue.
+	*/
+	template<class F>
+	void call_deferred(F &&function) {
+		CallQueue *call_queue = _get_deferred_call_queue();
+		if (call_queue)
+			call_queue->push(std::forward<F>(function));
+	}
+
+	/**
+	* @brief Calls @b method on @b object with @b args on the main thread after the current process or physics step.
+	* @see @b call_deferred.
+	*/
+	template<class T, class... Args, class... CallArgs>
+	void call_deferred(T *object, void (T::*method)(Args...), CallArgs&&... args) {
+		CallQueue *call_queue = _get_deferred_call_queue();
+		if (call_queue)
+			call_queue->push(object, method, std::forward<CallArgs>(args)...);
+	}
+
+	/**
+	* @brief Adds this node to the group @b group. @see @b SceneTree::call_group.
+	* @details Groups are kept while the node is outside the tree, but the node is only part of the group in the SceneTree while it is inside the tree.
+	* Nodes in a NodePool aren't part of the group in the SceneTree either, until they are taken from the pool.
+	*/
+	void add_to_group(const StringName &group);
+
+	void remove_from_group(const StringName &group);
+
+	/**
+	* @brief Returns @b true if this node has been added to @b group. This is constant time.
+	*/
+	bool is_in_group(const StringName &group) const;
+
+	/**
+	* @brief Returns the names of the groups this node has been added to, in no particular order.
+	*/
+	std::vector<StringName> get_groups() const;
+
+	/**
+	* @brief Returns the position of the node in the tree in depth-first order, parents come before their children and children are ordered by their index.
+	* @details Adding a node anywhere but at the end of the tree, or moving a child, renumbers the tree before the next process callbacks are called.
+	* Until then, the nodes that changed may have an order that doesn't match their position yet.
+	*/
+	constexpr uint64_t get_tree_order() const {
+		return tree_order;
+	}
+
 	/**
 	* @brief Queues a node for deletion at the end of the current frame.
 	* @details The deletion is equivalent to: @code delete note @endcode
 	* It is safe to call queue_free multiple times per frame on a node, and to free a node that is currently queued for deletion.
 	* Use @b is_queued_for_deletion to check whether an node will be deleted at the end of the frame.
 	* The node will only be freed after all other deferred calls are finished.
+	* Nodes created by a NodePool are returned to the pool instead of being deleted, see @b NodePool.
 	* @note The behavior is undefined the Node is not allocated with @b new.
 	*/
 	void queue_free();
@@ -304,6 +499,21 @@ public:
 		return is_deletion_queued;
 	}
 
+	/**
+	* @brief Returns the NodePool this node was created by, or @b nullptr if it wasn't created by a pool.
+	* @details Nodes with a pool are returned to it by @b queue_free instead of being deleted.
+	*/
+	constexpr NodePool *get_pool() const {
+		return pool;
+	}
+
+	/**
+	* @brief Returns @b true if the node has been returned to its pool and is waiting to be reused.
+	*/
+	constexpr bool is_in_pool() const {
+		return in_pool;
+	}
+
 	/**
 	* @brief Returns the SceneTree this node belongs to, or @b nullptr if the SceneTree hasn't been set.
 	*/
@@ -330,6 +540,7 @@ public:
 
 	/**
 	* @brief Sets the name of the Node.
+	* @note Must be called on the main thread, thread groups can use @b call_deferred.
 	*/
 	void set_name(const String &new_name);
 
@@ -341,8 +552,9 @@ public:
 	}
 
 	/**
-	* @brief Adds a child @b node.
-	* @details This methods overwrites the parent of the new child node.
+	* @brief Adds a child @b node after the last child.
+	* @details The child is removed from its previous parent first.
+	* @note Must be called on the main thread, thread groups can use @b call_deferred.
 	*/
 	void add_child(Node *child);
 
@@ -350,16 +562,73 @@ public:
 	* @brief Removes the Node @b child from this Node.
 	* @details If the @b child Node is inside the SceneTree, then the SceneTree of the @b child Node will be set to @b nullptr.
 	* Does nothing if the parent of the @b child Node is not this Node.
+	* The children after @b child shift down to keep their order, so removing takes linear time in the amount of children after it,
+	* and removing the last child takes constant time. Use @b remove_children to remove every child at once.
+	* @note Must be called on the main thread, thread groups can use @b call_deferred.
 	*/
 	void remove_child(Node *child);
 
 	/**
-	* @brief Returns an implementation defined container of all children.
+	* @brief Returns the children of this Node, in order.
 	*/
 	constexpr const children_t &get_children() const {
 		return children;
 	}
 
+	/**
+	* @brief Returns the child at @b child_index, or @b nullptr if the index is out of bounds.
+	*/
+	Node *get_child(const natural child_index) const {
+		return child_index < children.size() ? children[child_index] : nullptr;
+	}
+
+	natural get_child_count() const {
+		return children.size();
+	}
+
+	/**
+	* @brief Returns the index of this Node in the children of its parent.
+	* @details The index is cached, so this is a constant time operation. Returns 0 if the Node has no parent.
+	*/
+	constexpr natural get_index() const {
+		return index;
+	}
+
+	/**
+	* @brief Moves @b child to @b to_index in the children of this Node, shifting the children in between.
+	* @details Does nothing if the parent of @b child is not this Node. Indices past the last child move it to the end.
+	*/
+	void move_child(Node *child, const natural to_index);
+
+	/**
+	* @brief Returns the child named @b child_name, or @b nullptr if there is none.
+	* @details Direct children are looked up in a name index, so this is constant time. If @b recursive is true and no direct child has the name,
+	* the descendants of each child are searched in order. If several children have the same name, the first one added is returned.
+	*/
+	Node *find_child(const StringName &child_name, const bool recursive = false) const;
+
+	/**
+	* @brief Returns the node at @b path relative to this Node, or @b nullptr if there is none.
+	* @details Resolving looks up one name for each part of the path, and the result is cached in the path. @see @b NodePath.
+	*/
+	Node *get_node(const NodePath &path) const;
+
+	/**
+	* @brief Returns a number that changes every time a node is added, removed or renamed anywhere.
+	*/
+	static uint64_t get_tree_structure_version() {
+		return tree_structure_version.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Returns a number that changes when this node is renamed, gets another parent, or a child is added, removed or renamed.
+	* @details The number is unique among all nodes, even deleted ones. Used to check whether cached lookups, like the ones of NodePath,
+	* are still valid, without invalidating them for changes in unrelated parts of the tree.
+	*/
+	constexpr uint64_t get_structure_version() const {
+		return structure_version;
+	}
+
 	/**
 	* @brief Returns the parent of this Node.
 	*/
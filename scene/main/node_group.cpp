@@ -0,0 +1,88 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/main/node_group.hpp>
+#include <scene/main/node.hpp>
+
+using namespace Toof;
+using namespace Toof::detail;
+
+NodeGroup::NodeGroup(const StringName &name): name(name),
+    nodes(),
+    iteration_depth(0),
+    removed_node_count(0) {
+}
+
+void NodeGroup::_set_node_index(Node *node, const natural index) {
+	node->groups[name] = index;
+}
+
+void NodeGroup::_compact() {
+	natural new_size = 0;
+
+	for (natural i = 0; i < nodes.size(); i++) {
+		if (!nodes[i])
+			continue;
+
+		nodes[new_size] = nodes[i];
+		_set_node_index(nodes[new_size], new_size);
+		new_size++;
+	}
+
+	nodes.resize(new_size);
+	removed_node_count = 0;
+}
+
+void NodeGroup::add(Node *node) {
+	_set_node_index(node, nodes.size());
+	nodes.push_back(node);
+}
+
+void NodeGroup::remove(Node *node, const natural index) {
+	if (index >= nodes.size() || nodes[index] != node)
+		return;
+
+	if (iteration_depth) {
+		nodes[index] = nullptr;
+		removed_node_count++;
+		return;
+	}
+
+	nodes[index] = nodes.back();
+	_set_node_index(nodes[index], index);
+	nodes.pop_back();
+}
+
+void NodeGroup::end_iteration() {
+	iteration_depth--;
+	if (!iteration_depth && removed_node_count)
+		_compact();
+}
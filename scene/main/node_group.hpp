@@ -0,0 +1,104 @@
+/*  This file is part of the Toof Engine. */
+/** @file node_group.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/string/string_name.hpp>
+#include <core/math/math_defs.hpp>
+
+#include <vector>
+
+namespace Toof {
+
+class Node;
+
+namespace detail {
+
+/**
+* @brief The nodes inside the tree that are in a group, stored in a dense array.
+* @details Every node caches its index in the array, so nodes are added and removed in constant time.
+* Removing a node moves the last node in its place, unless the group is being iterated. Then the node is set to @b nullptr,
+* and the array is compacted once the iteration is done.
+*/
+class NodeGroup {
+	StringName name;
+	std::vector<Node*> nodes;
+	natural iteration_depth;
+	natural removed_node_count;
+
+	void _set_node_index(Node *node, const natural index);
+	void _compact();
+public:
+	explicit NodeGroup(const StringName &name);
+
+	void add(Node *node);
+	void remove(Node *node, const natural index);
+
+	/**
+	* @brief Returns the nodes in the group. May contain @b nullptr while the group is being iterated.
+	*/
+	constexpr const std::vector<Node*> &get_nodes() const {
+		return nodes;
+	}
+
+	/**
+	* @brief Keeps nodes from being moved or removed from the array, until @b end_iteration is called.
+	*/
+	constexpr void begin_iteration() {
+		iteration_depth++;
+	}
+
+	void end_iteration();
+
+	/**
+	* @brief Returns the amount of nodes in the group, without the nodes removed while the group is being iterated.
+	*/
+	natural get_node_count() const {
+		return nodes.size() - removed_node_count;
+	}
+
+	template<class F>
+	void for_each(const F &function) {
+		begin_iteration();
+
+		// Nodes added during the iteration are called as well, the vector is indexed so it can grow.
+		for (natural i = 0; i < nodes.size(); i++)
+			if (nodes[i])
+				function(nodes[i]);
+
+		end_iteration();
+	}
+};
+
+}
+
+}
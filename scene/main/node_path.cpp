@@ -0,0 +1,144 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/main/node_path.hpp>
+#include <scene/main/node.hpp>
+
+using namespace Toof;
+
+static const StringName &get_parent_name() {
+	static const StringName parent_name("..");
+	return parent_name;
+}
+
+static const StringName &get_self_name() {
+	static const StringName self_name(".");
+	return self_name;
+}
+
+NodePath::NodePath(): names(),
+    absolute(false),
+    cached_chain(),
+    cached_node(nullptr) {
+}
+
+NodePath::NodePath(const String &path): NodePath() {
+	absolute = !path.empty() && path.front() == '/';
+
+	String::size_type start = 0;
+	while (start <= path.size()) {
+		String::size_type end = path.find('/', start);
+		if (end == String::npos)
+			end = path.size();
+
+		if (end > start)
+			names.push_back(StringName(path.substr(start, end - start)));
+
+		start = end + 1;
+	}
+}
+
+NodePath::NodePath(const char *path): NodePath(String(path)) {
+}
+
+void NodePath::_cache_node(const Node *node) const {
+	cached_chain.push_back({node, node->get_structure_version()});
+}
+
+bool NodePath::_is_cache_valid(const Node *from) const {
+	if (cached_chain.empty() || cached_chain.front().first != from)
+		return false;
+
+	// Checked in order, an unchanged node still has the same parent and children, so the next node in the chain still exists.
+	for (const auto &[node, structure_version]: cached_chain)
+		if (node->get_structure_version() != structure_version)
+			return false;
+
+	return true;
+}
+
+Node *NodePath::_resolve(const Node *from) const {
+	const Node *node = from;
+	cached_chain.clear();
+	_cache_node(node);
+
+	if (absolute) {
+		while (node->get_parent()) {
+			node = node->get_parent();
+			_cache_node(node);
+		}
+
+		// The first name of an absolute path is the name of the top node itself.
+		if (names.empty())
+			return const_cast<Node*>(node);
+		if (node->get_name() != names.front().get_string())
+			return nullptr;
+	}
+
+	for (natural i = absolute ? 1 : 0; i < names.size() && node; i++) {
+		const StringName &name = names[i];
+
+		if (name == get_parent_name())
+			node = node->get_parent();
+		else if (name != get_self_name())
+			node = node->find_child(name);
+		else
+			continue;
+
+		if (node)
+			_cache_node(node);
+	}
+
+	return const_cast<Node*>(node);
+}
+
+Node *NodePath::resolve(const Node *from) const {
+	if (!from)
+		return nullptr;
+
+	if (_is_cache_valid(from))
+		return cached_node;
+
+	cached_node = _resolve(from);
+	return cached_node;
+}
+
+NodePath::operator String() const {
+	String path = absolute ? "/" : "";
+
+	for (natural i = 0; i < names.size(); i++) {
+		if (i > 0)
+			path += '/';
+		path += String(names[i]);
+	}
+
+	return path;
+}
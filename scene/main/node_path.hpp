@@ -0,0 +1,94 @@
+/*  This file is part of the Toof Engine. */
+/** @file node_path.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/string/string_name.hpp>
+#include <core/math/math_defs.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace Toof {
+
+class Node;
+
+/**
+* @brief A path to a node, made of node names separated by slashes.
+* @details Paths are relative to the node they are resolved from, unless they start with a slash, in which case they start at the top node of the tree.
+* The name ".." refers to the parent and "." to the node itself, for example "../Enemies/Enemy" or "/Root/Player/Sprite".
+* The names are parsed once. Resolving looks up one name per step in the name index of the parent, and the result is cached
+* until a node the path passes through is renamed, moved to another parent or gets children added or removed,
+* see @b Node::get_structure_version. Changes in other parts of the tree keep the cached result.
+*/
+class NodePath {
+	std::vector<StringName> names;
+	bool absolute;
+
+	// The nodes the last resolve passed through, starting at the node it was resolved from, with their structure versions at the time.
+	mutable std::vector<std::pair<const Node*, uint64_t>> cached_chain;
+	mutable Node *cached_node;
+
+	void _cache_node(const Node *node) const;
+	bool _is_cache_valid(const Node *from) const;
+	Node *_resolve(const Node *from) const;
+public:
+	NodePath();
+	NodePath(const String &path);
+	NodePath(const char *path);
+
+	constexpr bool is_absolute() const {
+		return absolute;
+	}
+
+	bool is_empty() const {
+		return names.empty() && !absolute;
+	}
+
+	natural get_name_count() const {
+		return names.size();
+	}
+
+	const StringName &get_name(const natural index) const {
+		return names[index];
+	}
+
+	/**
+	* @brief Returns the node this path points to starting from @b from, or @b nullptr if there's no such node.
+	* @details The result is cached, as long as the structure of the tree doesn't change resolving from the same node again is constant time.
+	*/
+	Node *resolve(const Node *from) const;
+
+	operator String() const;
+};
+
+}
@@ -0,0 +1,119 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/main/node_pool.hpp>
+#include <scene/main/node.hpp>
+
+#include <algorithm>
+
+using namespace Toof;
+
+NodePool::NodePool(const CreateFunction &create_function): free_nodes(),
+    active_nodes(),
+    create_function(create_function),
+    created_count(0),
+    reuse_count(0),
+    peak_active_count(0) {
+}
+
+NodePool::~NodePool() {
+	for (Node *node: active_nodes)
+		node->pool = nullptr;
+
+	std::vector<Node*> deleted_nodes;
+	deleted_nodes.swap(free_nodes);
+
+	for (Node *node: deleted_nodes) {
+		node->pool = nullptr;
+		delete node;
+	}
+}
+
+void NodePool::_add_node(std::vector<Node*> &nodes, Node *node) {
+	node->pool_index = nodes.size();
+	nodes.push_back(node);
+}
+
+void NodePool::_remove_node(std::vector<Node*> &nodes, Node *node) {
+	const natural index = node->pool_index;
+	if (index >= nodes.size() || nodes[index] != node)
+		return;
+
+	nodes[index] = nodes.back();
+	nodes[index]->pool_index = index;
+	nodes.pop_back();
+}
+
+Node *NodePool::_create_node() {
+	Node *node = create_function();
+	node->pool = this;
+	created_count++;
+	return node;
+}
+
+void NodePool::_return_node(Node *node) {
+	_remove_node(active_nodes, node);
+	node->_return_to_pool();
+	_add_node(free_nodes, node);
+}
+
+void NodePool::_on_node_deleted(Node *node) {
+	_remove_node(node->is_in_pool() ? free_nodes : active_nodes, node);
+}
+
+Node *NodePool::acquire(Node *parent) {
+	Node *node = nullptr;
+
+	if (free_nodes.empty())
+		node = _create_node();
+	else {
+		node = free_nodes.back();
+		free_nodes.pop_back();
+		node->_take_from_pool();
+		reuse_count++;
+	}
+
+	_add_node(active_nodes, node);
+	peak_active_count = std::max<natural>(peak_active_count, active_nodes.size());
+
+	if (parent)
+		parent->add_child(node);
+
+	return node;
+}
+
+void NodePool::reserve(const natural count) {
+	while (free_nodes.size() < count) {
+		Node *node = _create_node();
+		node->_return_to_pool();
+		_add_node(free_nodes, node);
+	}
+}
@@ -0,0 +1,130 @@
+/*  This file is part of the Toof Engine. */
+/** @file node_pool.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace Toof {
+
+class Node;
+
+/**
+* @brief A pool of nodes of one type, that are reused instead of being deleted and allocated again.
+* @details Nodes taken from a pool are returned to it when they are freed with @b Node::queue_free.
+* Returned nodes stay in the tree with their parent and their canvas item, but are hidden and don't receive any process or input callbacks.
+* Taking a node from the pool, returning it and deleting it are constant time, taking a node doesn't allocate if a returned node is available.
+* Nodes receive @b Node::NOTIFICATION_RETURNED_TO_POOL and @b Node::NOTIFICATION_TAKEN_FROM_POOL, which can be used to reset their state.
+* @see @b SceneTree::get_node_pool.
+*/
+class NodePool {
+public:
+	using CreateFunction = std::function<Node*()>;
+private:
+	std::vector<Node*> free_nodes;
+	std::vector<Node*> active_nodes;
+	CreateFunction create_function;
+	natural created_count;
+	natural reuse_count;
+	natural peak_active_count;
+
+	static void _add_node(std::vector<Node*> &nodes, Node *node);
+	static void _remove_node(std::vector<Node*> &nodes, Node *node);
+	Node *_create_node();
+	void _return_node(Node *node);
+	void _on_node_deleted(Node *node);
+
+	friend Node;
+	friend class SceneTree;
+public:
+	explicit NodePool(const CreateFunction &create_function);
+
+	/**
+	* @brief Deletes the nodes in the pool. Nodes taken from the pool are kept and are deleted by @b Node::queue_free from then on.
+	*/
+	~NodePool();
+
+	NodePool(const NodePool&) = delete;
+	NodePool &operator=(const NodePool&) = delete;
+
+	/**
+	* @brief Takes a node from the pool, or creates a new one if the pool is empty.
+	* @details If @b parent is not @b nullptr, the node is added as a child of @b parent. A node that was returned while being a child of
+	* @b parent is reused without leaving the tree, other nodes are moved to @b parent.
+	*/
+	Node *acquire(Node *parent = nullptr);
+
+	/**
+	* @brief Creates nodes until the pool holds at least @b count nodes, so they don't have to be created later.
+	*/
+	void reserve(const natural count);
+
+	/**
+	* @brief Returns the amount of nodes in the pool, ready to be acquired.
+	*/
+	natural get_free_count() const {
+		return free_nodes.size();
+	}
+
+	/**
+	* @brief Returns the amount of nodes taken from the pool that haven't been returned.
+	*/
+	natural get_active_count() const {
+		return active_nodes.size();
+	}
+
+	/**
+	* @brief Returns the highest amount of active nodes at the same time.
+	*/
+	constexpr natural get_peak_active_count() const {
+		return peak_active_count;
+	}
+
+	/**
+	* @brief Returns the amount of nodes the pool has created.
+	*/
+	constexpr natural get_created_count() const {
+		return created_count;
+	}
+
+	/**
+	* @brief Returns the amount of times a returned node has been acquired again, instead of creating a new node.
+	*/
+	constexpr natural get_reuse_count() const {
+		return reuse_count;
+	}
+};
+
+}
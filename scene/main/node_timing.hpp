@@ -0,0 +1,108 @@
+/*  This file is part of the Toof Engine. */
+/** @file node_timing.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+#include <scene/main/process_list.hpp>
+
+#include <algorithm>
+#include <array>
+#include <typeindex>
+
+namespace Toof {
+
+class Node;
+
+/**
+* @brief The rolling average and maximum time in seconds that a callback took per step.
+*/
+struct CallbackTiming {
+	double average;
+	double maximum;
+};
+
+/**
+* @brief The time in seconds that the callbacks of a node took in a single frame.
+*/
+struct NodeTimeReport {
+	Node *node;
+	std::type_index type;
+	double time;
+};
+
+namespace detail {
+
+class TimingStats {
+	double average;
+	double maximum;
+	double window_maximum;
+	natural window_samples;
+	bool has_samples;
+public:
+	/**
+	* @brief The amount of samples the maximum is taken over, the maximum of the previous window is kept until the current one is full.
+	*/
+	static constexpr natural WINDOW_SIZE = 120;
+
+	constexpr TimingStats(): average(0.0), maximum(0.0), window_maximum(0.0), window_samples(0), has_samples(false) {
+	}
+
+	constexpr void add_sample(const double time) {
+		average = has_samples ? average + (time - average) * 0.1 : time;
+		window_maximum = std::max(window_maximum, time);
+		has_samples = true;
+
+		if (++window_samples >= WINDOW_SIZE) {
+			maximum = window_maximum;
+			window_maximum = 0.0;
+			window_samples = 0;
+		}
+	}
+
+	constexpr CallbackTiming get_timing() const {
+		return CallbackTiming {average, std::max(maximum, window_maximum)};
+	}
+};
+
+/**
+* @brief The time a node spent in its callbacks during the current step and frame, and the statistics of the previous steps.
+*/
+struct NodeTimings {
+	std::array<int64_t, PROCESS_CALLBACK_MAX> step_time = {};
+	int64_t frame_time = 0;
+	std::array<TimingStats, PROCESS_CALLBACK_MAX> stats = {};
+};
+
+}
+
+}
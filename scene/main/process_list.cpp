@@ -0,0 +1,116 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <scene/main/process_list.hpp>
+#include <scene/main/node.hpp>
+
+#include <algorithm>
+
+using namespace Toof;
+using namespace Toof::detail;
+
+ProcessList::ProcessList(const ProcessCallback callback): nodes(),
+    pending_nodes(),
+    iteration_depth(0),
+    callback(callback),
+    sorted(true),
+    has_removed_nodes(false) {
+}
+
+void ProcessList::_set_node_index(Node *node, const natural index) const {
+	node->process_list_indices[callback] = index;
+}
+
+natural ProcessList::_get_node_index(const Node *node) const {
+	return node->process_list_indices[callback];
+}
+
+void ProcessList::_flush() {
+	bool moved_nodes = false;
+
+	if (has_removed_nodes) {
+		nodes.erase(std::remove(nodes.begin(), nodes.end(), nullptr), nodes.end());
+		has_removed_nodes = false;
+		moved_nodes = true;
+	}
+
+	if (!pending_nodes.empty()) {
+		nodes.insert(nodes.end(), pending_nodes.begin(), pending_nodes.end());
+		pending_nodes.clear();
+		sorted = false;
+	}
+
+	if (!sorted) {
+		std::stable_sort(nodes.begin(), nodes.end(), [](const Node *left, const Node *right) {
+			if (left->get_process_priority() != right->get_process_priority())
+				return left->get_process_priority() < right->get_process_priority();
+			return left->get_tree_order() < right->get_tree_order();
+		});
+		sorted = true;
+		moved_nodes = true;
+	}
+
+	if (moved_nodes)
+		for (natural i = 0; i < nodes.size(); i++)
+			_set_node_index(nodes[i], i);
+}
+
+void ProcessList::add(Node *node) {
+	if (_get_node_index(node) != INVALID_INDEX)
+		return;
+
+	_set_node_index(node, pending_nodes.size() | PENDING_INDEX_BIT);
+	pending_nodes.push_back(node);
+}
+
+void ProcessList::remove(Node *node) {
+	const natural index = _get_node_index(node);
+	if (index == INVALID_INDEX)
+		return;
+
+	_set_node_index(node, INVALID_INDEX);
+
+	// Pending nodes are sorted once they are added to the list, so their order doesn't matter.
+	if (index & PENDING_INDEX_BIT) {
+		const natural pending_index = index & ~PENDING_INDEX_BIT;
+		pending_nodes[pending_index] = pending_nodes.back();
+		pending_nodes.pop_back();
+
+		if (pending_index < pending_nodes.size())
+			_set_node_index(pending_nodes[pending_index], pending_index | PENDING_INDEX_BIT);
+		return;
+	}
+
+	// The list may be iterated, so the node is only cleared and the list is compacted before the next iteration.
+	nodes[index] = nullptr;
+	has_removed_nodes = true;
+}
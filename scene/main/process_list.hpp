@@ -0,0 +1,140 @@
+/*  This file is part of the Toof Engine. */
+/** @file process_list.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+#include <core/memory/call_queue.hpp>
+
+#include <array>
+#include <vector>
+
+namespace Toof {
+
+class Node;
+
+namespace detail {
+
+enum ProcessCallback : int {
+	PROCESS_CALLBACK_PROCESS,
+	PROCESS_CALLBACK_PHYSICS_PROCESS,
+	PROCESS_CALLBACK_RENDER,
+	PROCESS_CALLBACK_INPUT,
+	PROCESS_CALLBACK_MAX
+};
+
+/**
+* @brief A contiguous list of nodes that receive a callback each step, ordered by process priority and then tree order.
+* @details Nodes can be added and removed while the list is being iterated.
+* Added nodes are called from the next iteration on, removed nodes are not called anymore.
+* Every node caches its index in the list of each callback, so nodes are added and removed in constant time.
+*/
+class ProcessList {
+public:
+	static constexpr natural INVALID_INDEX = ~natural(0);
+
+private:
+	// Set in the cached index of nodes that are waiting in @b pending_nodes.
+	static constexpr natural PENDING_INDEX_BIT = ~(~natural(0) >> 1);
+
+	std::vector<Node*> nodes;
+	std::vector<Node*> pending_nodes;
+	natural iteration_depth;
+	ProcessCallback callback;
+	bool sorted;
+	bool has_removed_nodes;
+
+	void _set_node_index(Node *node, const natural index) const;
+	natural _get_node_index(const Node *node) const;
+	void _flush();
+public:
+	explicit ProcessList(const ProcessCallback callback);
+
+	void add(Node *node);
+	void remove(Node *node);
+
+	/**
+	* @brief Sorts the list again before the next iteration, should be called when the process priority of a node in the list changes.
+	*/
+	constexpr void mark_unsorted() {
+		sorted = false;
+	}
+
+	template<class F>
+	void for_each(const F &function) {
+		if (!iteration_depth)
+			_flush();
+
+		iteration_depth++;
+
+		// The vector isn't resized during the iteration, so indexing stays valid. Removed nodes are set to nullptr.
+		for (natural i = 0; i < nodes.size(); i++)
+			if (nodes[i])
+				function(nodes[i]);
+
+		iteration_depth--;
+	}
+
+	/**
+	* @brief Calls @b function with the nodes in reverse order, until @b function returns true.
+	*/
+	template<class F>
+	void for_each_reverse_until(const F &function) {
+		if (!iteration_depth)
+			_flush();
+
+		iteration_depth++;
+
+		for (natural i = nodes.size(); i > 0; i--)
+			if (nodes[i - 1] && function(nodes[i - 1]))
+				break;
+
+		iteration_depth--;
+	}
+};
+
+/**
+* @brief The process lists and deferred calls of the nodes in one process thread group.
+*/
+struct ProcessGroup {
+	std::array<ProcessList, PROCESS_CALLBACK_MAX> process_lists = {
+		ProcessList(PROCESS_CALLBACK_PROCESS),
+		ProcessList(PROCESS_CALLBACK_PHYSICS_PROCESS),
+		ProcessList(PROCESS_CALLBACK_RENDER),
+		ProcessList(PROCESS_CALLBACK_INPUT),
+	};
+	CallQueue deferred_calls;
+};
+
+}
+
+}
@@ -36,6 +36,9 @@
 #include <servers/rendering_server.hpp>
 #include <input/input.hpp>
 #include <input/input_event.hpp>
+#include <input/input_recording.hpp>
+#include <core/os/thread_pool.hpp>
+#include <core/os/profiler.hpp>
 
 #ifdef TOOF_PHYSICS_ENABLED
 #include <servers/physics_server.hpp>
@@ -43,14 +46,29 @@
 
 #include <SDL_timer.h>
 
-#include <thread>
+#include <algorithm>
+#include <cmath>
 #include <chrono>
+#include <thread>
 
 using namespace Toof;
 
-SceneTree::SceneTree() {
+SceneTree::SceneTree(const bool headless) {
 	running = false;
 	paused = false;
+	event_paused = false;
+	low_processor_mode = false;
+	this->headless = headless;
+	node_timing_enabled = false;
+	input_handled = false;
+	input_player = nullptr;
+	node_time_budget = 0.0;
+	physics_time_accumulator = 0.0;
+	physics_interpolation_fraction = 1.0;
+	max_physics_substeps = 8;
+	tree_order_counter = 0;
+	tree_order_dirty = false;
+	frame_callback_times = {};
 
 	const long time = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 
@@ -59,23 +77,29 @@ SceneTree::SceneTree() {
 	render_loop = Loop();
 
 	process_loop.prev_step_time = time;
+	process_loop.next_step_time = time;
 	process_loop.loop_type = Loop::LOOP_TYPE_PROCESS;
 
 	render_loop.prev_step_time = time;
+	render_loop.next_step_time = time;
 	render_loop.loop_type = Loop::LOOP_TYPE_RENDER;
 
-	window = std::make_unique<Window>();
-	viewport = std::make_unique<Viewport>();
-	rendering_server = std::make_unique<RenderingServer>(viewport.get());
+	if (!headless) {
+		window = std::make_unique<Window>();
+		viewport = std::make_unique<Viewport>();
+		rendering_server = std::make_unique<RenderingServer>(viewport.get());
+		viewport->create(window.get());
+	}
+
 	root = std::make_unique<Node>();
 	input = std::make_unique<Input>(&process_loop.step_count, &render_loop.step_count);
 
-	viewport->create(window.get());
 	root->set_name("Root");
 	root->set_tree(this);
 
 	#ifdef TOOF_PHYSICS_ENABLED
 	physics_loop.prev_step_time = time;
+	physics_loop.next_step_time = time;
 	physics_loop.loop_type = Loop::LOOP_TYPE_PHYSICS;
 
 	physics_server = std::make_unique<PhysicsServer2D>();
@@ -84,6 +108,9 @@ SceneTree::SceneTree() {
 
 SceneTree::~SceneTree() {
 	stop();
+
+	// The nodes leave the tree before the RenderingServer is destroyed, so the textures they draw are unloaded from it.
+	root.reset();
 }
 
 void SceneTree::_initialize() {
@@ -97,62 +124,392 @@ void SceneTree::_add_child(Node *child) {
 		root->add_child(child);
 }
 
+static long get_time_now() {
+	return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+}
+
 void SceneTree::step_render(const double delta) {
+	TOOF_PROFILE_ZONE("SceneTree::step_render");
 	render_loop.delta_time = delta * render_loop.time_scale;
 	render_frame();
 
-	if (root)
-		root->propagate_notification(Node::NOTIFICATION_RENDER);
-	rendering_server->render();
+	#ifdef TOOF_PHYSICS_ENABLED
+	_update_physics_interpolation_fraction(get_time_now());
+	#endif
+
+	_update_tree_order();
+	main_process_group.process_lists[detail::PROCESS_CALLBACK_RENDER].for_each([](Node *node) {
+		node->notification(Node::NOTIFICATION_RENDER);
+	});
+	_collect_node_timings(detail::PROCESS_CALLBACK_RENDER);
+	_end_node_timing_frame();
+
+	if (rendering_server)
+		rendering_server->render();
 }
 
 void SceneTree::step_process(const double delta) {
+	TOOF_PROFILE_ZONE("SceneTree::step_process");
 	process_loop.delta_time = delta * process_loop.time_scale;
+	_play_input_frame();
+	_push_coalesced_input_events();
 	process_frame();
 
-	if (root)
-		root->propagate_notification(Node::NOTIFICATION_PROCESS);
-
-	deferred_signals();
+	_step_process_groups(detail::PROCESS_CALLBACK_PROCESS, Node::NOTIFICATION_PROCESS);
+	_collect_node_timings(detail::PROCESS_CALLBACK_PROCESS);
 
-	for (Node *item: deferred_item_removal)
-		delete item;
+	std::vector<Node*> removed_items;
+	{
+		std::lock_guard<std::mutex> lock(deferred_item_removal_mutex);
+		removed_items.swap(deferred_item_removal);
+	}
 
-	deferred_signals.disconnect_all();
-	deferred_item_removal.clear();
+	for (Node *item: removed_items) {
+		if (item->get_pool())
+			item->get_pool()->_return_node(item);
+		else
+			delete item;
+	}
+	input->flush_events();
 }
 
 void SceneTree::step_event() {
+	TOOF_PROFILE_ZONE("SceneTree::step_event");
 	if (event->type == SDL_QUIT)
 		stop();
 
-	const std::shared_ptr<InputEvent> &input_event = input->process_event(event.get());
-	if (root && input_event)
-		root->propagate_input_event(input_event);
+	if (rendering_server)
+		rendering_server->request_redraw();
+
+	if (!input_player)
+		push_sdl_event(event.get());
 }
 
-void SceneTree::step_physics(const double delta) {
-	#ifndef TOOF_PHYSICS_ENABLED
-	return;
-	#endif
+void SceneTree::push_sdl_event(const SDL_Event *sdl_event) {
+	// Merged motion events happened before this event, so they are sent first.
+	if (!Input::is_coalesced_event_type(get_event_type(sdl_event)))
+		_push_coalesced_input_events();
+
+	const InputEventRef input_event = input->process_event(sdl_event);
+	if (input_event)
+		push_input_event(input_event);
+}
+
+void SceneTree::_push_coalesced_input_events() {
+	input->flush_coalesced_events([this](const InputEventRef input_event) {
+		push_input_event(input_event);
+	});
+}
+
+void SceneTree::_play_input_frame() {
+	if (!input_player)
+		return;
 
+	SDL_Event recorded_event;
+	while (input_player->next_event(process_loop.step_count, &recorded_event))
+		push_sdl_event(&recorded_event);
+}
+
+void SceneTree::push_input_event(const InputEventRef input_event) {
+	input_handled = false;
+	_update_tree_order();
+	main_process_group.process_lists[detail::PROCESS_CALLBACK_INPUT].for_each_reverse_until([this, &input_event](Node *node) {
+		node->_input_event(input_event);
+		return input_handled;
+	});
+}
+
+void SceneTree::step_physics([[maybe_unused]] const double delta) {
+	#ifdef TOOF_PHYSICS_ENABLED
+	TOOF_PROFILE_ZONE("SceneTree::step_physics");
 	physics_loop.delta_time = delta * physics_loop.time_scale;
 	physics_frame();
 
-	if (root)
-		root->propagate_notification(Node::NOTIFICATION_PREDELETE);
-
+	_step_process_groups(detail::PROCESS_CALLBACK_PHYSICS_PROCESS, Node::NOTIFICATION_PHYSICS_PROCESS);
 	physics_server->tick(physics_loop.delta_time);
+	_step_process_groups(detail::PROCESS_CALLBACK_PHYSICS_PROCESS, Node::NOTIFICATION_POST_PHYSICS_PROCESS);
+	_collect_node_timings(detail::PROCESS_CALLBACK_PHYSICS_PROCESS);
+	#endif
+}
+
+void SceneTree::_create_process_group(const natural thread_group) {
+	if (!thread_group || !thread_process_groups.try_emplace(thread_group).second)
+		return;
+
+	thread_process_group_list.clear();
+	for (auto &[group, process_group]: thread_process_groups)
+		thread_process_group_list.push_back(&process_group);
+
+	_get_thread_pool();
+}
+
+detail::ProcessGroup &SceneTree::_get_process_group(const natural thread_group) {
+	if (!thread_group)
+		return main_process_group;
+
+	// Only looks the group up, so worker threads can call it while deferring calls. The group was created when the node entered the tree.
+	const auto iterator = thread_process_groups.find(thread_group);
+	return iterator != thread_process_groups.end() ? iterator->second : main_process_group;
+}
+
+ThreadPool &SceneTree::_get_thread_pool() {
+	if (!thread_pool)
+		thread_pool = std::make_unique<ThreadPool>();
+
+	return *thread_pool;
+}
+
+detail::NodeGroup &SceneTree::_get_group(const StringName &group) {
+	return groups.try_emplace(group, group).first->second;
+}
+
+detail::NodeGroup *SceneTree::_find_group(const StringName &group) {
+	const auto iterator = groups.find(group);
+	return iterator == groups.end() ? nullptr : &iterator->second;
+}
+
+const detail::NodeGroup *SceneTree::_find_group(const StringName &group) const {
+	const auto iterator = groups.find(group);
+	return iterator == groups.end() ? nullptr : &iterator->second;
+}
+
+void SceneTree::call_group_parallel(const StringName &group, const std::function<void(Node*)> &function) {
+	detail::NodeGroup *node_group = _find_group(group);
+	if (!node_group)
+		return;
+
+	ThreadPool &pool = _get_thread_pool();
+	const std::vector<Node*> &nodes = node_group->get_nodes();
+
+	// A few ranges per thread, so threads that finish early can steal the remaining ranges.
+	const natural range_count = std::min<natural>(nodes.size(), (pool.get_thread_count() + 1) * 4);
+	if (!range_count)
+		return;
+
+	const natural range_size = (nodes.size() + range_count - 1) / range_count;
+
+	node_group->begin_iteration();
+	pool.parallel_for(range_count, [&nodes, &function, range_size](const natural range) {
+		const natural end = std::min<natural>(nodes.size(), (range + 1) * range_size);
+
+		for (natural i = range * range_size; i < end; i++)
+			if (nodes[i])
+				function(nodes[i]);
+	});
+	node_group->end_iteration();
+}
+
+void SceneTree::notify_group(const StringName &group, const int what) {
+	call_group(group, [what](Node *node) {
+		node->notification(what);
+	});
+}
+
+std::vector<Node*> SceneTree::get_nodes_in_group(const StringName &group) const {
+	std::vector<Node*> nodes;
+
+	if (const detail::NodeGroup *node_group = _find_group(group))
+		for (Node *node: node_group->get_nodes())
+			if (node)
+				nodes.push_back(node);
+
+	return nodes;
+}
+
+natural SceneTree::get_group_node_count(const StringName &group) const {
+	const detail::NodeGroup *node_group = _find_group(group);
+	return node_group ? node_group->get_node_count() : 0;
+}
+
+bool SceneTree::has_group(const StringName &group) const {
+	return get_group_node_count(group);
+}
+
+void SceneTree::_step_process_groups(const detail::ProcessCallback callback, const int what) {
+	_update_tree_order();
+
+	const auto notify_nodes = [callback, what](detail::ProcessGroup &process_group) {
+		process_group.process_lists[callback].for_each([what](Node *node) {
+			node->notification(what);
+		});
+	};
+
+	// Every thread group has finished once parallel_for returns, before the main thread group or any deferred call runs.
+	if (thread_pool)
+		thread_pool->parallel_for(thread_process_group_list.size(), [this, &notify_nodes](const natural index) {
+			notify_nodes(*thread_process_group_list[index]);
+		});
+
+	notify_nodes(main_process_group);
+	_flush_deferred_calls();
+}
+
+void SceneTree::_update_tree_order() {
+	if (!tree_order_dirty)
+		return;
+
+	tree_order_dirty = false;
+	tree_order_counter = 0;
+	root->_update_tree_order(tree_order_counter);
+
+	const auto mark_unsorted = [](detail::ProcessGroup &process_group) {
+		for (detail::ProcessList &process_list: process_group.process_lists)
+			process_list.mark_unsorted();
+	};
+
+	mark_unsorted(main_process_group);
+	for (detail::ProcessGroup *process_group: thread_process_group_list)
+		mark_unsorted(*process_group);
+}
+
+NodePool &SceneTree::_get_node_pool(const std::type_index &type, Node *(*create_function)()) {
+	std::unique_ptr<NodePool> &node_pool = node_pools[type];
+	if (!node_pool)
+		node_pool = std::make_unique<NodePool>(create_function);
+
+	return *node_pool;
+}
+
+void SceneTree::_flush_deferred_calls() {
+	// Thread groups are flushed in order of their id so the result doesn't depend on which thread finished first.
+	for (natural i = 0; i < thread_process_group_list.size(); i++)
+		thread_process_group_list[i]->deferred_calls.flush();
+
+	main_process_group.deferred_calls.flush();
+}
+
+void SceneTree::_collect_node_timings(const detail::ProcessCallback callback) {
+	if (!node_timing_enabled)
+		return;
+
+	std::unordered_map<std::type_index, int64_t> type_step_times;
+
+	const auto collect_nodes = [&](detail::ProcessGroup &process_group) {
+		process_group.process_lists[callback].for_each([&](Node *node) {
+			if (!node->timings)
+				return;
+
+			int64_t &node_step_time = node->timings->step_time[callback];
+
+			node->timings->stats[callback].add_sample(static_cast<double>(node_step_time) / std::nano::den);
+			node->timings->frame_time += node_step_time;
+			type_step_times[typeid(*node)] += node_step_time;
+			frame_callback_times[callback] += node_step_time;
+			node_step_time = 0;
+		});
+	};
+
+	for (detail::ProcessGroup *process_group: thread_process_group_list)
+		collect_nodes(*process_group);
+	collect_nodes(main_process_group);
+
+	for (const auto &[type, type_step_time]: type_step_times)
+		type_timings[type][callback].add_sample(static_cast<double>(type_step_time) / std::nano::den);
+}
+
+void SceneTree::_end_node_timing_frame() {
+	if (!node_timing_enabled)
+		return;
+
+	// The budget is for the whole frame, which can have several process and physics steps.
+	int64_t frame_time = 0;
+	for (const int64_t callback_time: frame_callback_times)
+		frame_time += callback_time;
+
+	const natural longest_callback = std::max_element(frame_callback_times.begin(), frame_callback_times.end()) - frame_callback_times.begin();
+	const bool budget_exceeded = node_time_budget > 0.0 && static_cast<double>(frame_time) / std::nano::den > node_time_budget;
+	std::vector<NodeTimeReport> reports;
+	frame_callback_times = {};
+
+	// A node is in the list of every callback it uses, so its frame time is reset the first time it is visited.
+	const auto collect_nodes = [&](detail::ProcessGroup &process_group) {
+		for (const detail::ProcessCallback callback: {detail::PROCESS_CALLBACK_PROCESS, detail::PROCESS_CALLBACK_PHYSICS_PROCESS, detail::PROCESS_CALLBACK_RENDER}) {
+			process_group.process_lists[callback].for_each([&](Node *node) {
+				if (!node->timings || !node->timings->frame_time)
+					return;
+
+				if (budget_exceeded)
+					reports.push_back({node, typeid(*node), static_cast<double>(node->timings->frame_time) / std::nano::den});
+				node->timings->frame_time = 0;
+			});
+		}
+	};
+
+	for (detail::ProcessGroup *process_group: thread_process_group_list)
+		collect_nodes(*process_group);
+	collect_nodes(main_process_group);
+
+	if (!budget_exceeded)
+		return;
+
+	int what = Node::NOTIFICATION_PROCESS;
+	if (longest_callback == detail::PROCESS_CALLBACK_PHYSICS_PROCESS)
+		what = Node::NOTIFICATION_PHYSICS_PROCESS;
+	else if (longest_callback == detail::PROCESS_CALLBACK_RENDER)
+		what = Node::NOTIFICATION_RENDER;
+
+	const natural offender_count = std::min(reports.size(), NODE_TIME_BUDGET_OFFENDERS);
+	std::partial_sort(reports.begin(), reports.begin() + offender_count, reports.end(), [](const NodeTimeReport &left, const NodeTimeReport &right) {
+		return left.time > right.time;
+	});
+	reports.erase(reports.begin() + offender_count, reports.end());
+
+	node_time_budget_exceeded(what, reports);
+}
+
+CallbackTiming SceneTree::get_node_timing(const Node *node, const int what) const {
+	const detail::ProcessCallback callback = Node::_get_timed_callback(what);
+
+	if (!node || !node->timings || callback == detail::PROCESS_CALLBACK_MAX)
+		return CallbackTiming {0.0, 0.0};
+
+	return node->timings->stats[callback].get_timing();
+}
+
+CallbackTiming SceneTree::get_type_timing(const std::type_index &type, const int what) const {
+	const detail::ProcessCallback callback = Node::_get_timed_callback(what);
+	const auto iterator = type_timings.find(type);
+
+	if (iterator == type_timings.end() || callback == detail::PROCESS_CALLBACK_MAX)
+		return CallbackTiming {0.0, 0.0};
+
+	return iterator->second[callback].get_timing();
 }
 
-void SceneTree::_do_loop(Loop &loop) {
-	const long time_now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-	const long delta = (time_now - loop.prev_step_time);
-	const double step_time = loop.speed_scale / loop.frame_rate;
-	const double true_delta = static_cast<double>(delta) / std::nano::den;
+void SceneTree::_step_physics_fixed(const double delta) {
+	const double fixed_delta = physics_loop.get_step_time();
+	natural substeps = 0;
 
-	if (true_delta < step_time)
+	physics_time_accumulator += delta;
+	while (physics_time_accumulator >= fixed_delta && substeps < max_physics_substeps) {
+		step_physics(fixed_delta);
+		physics_time_accumulator -= fixed_delta;
+		substeps++;
+	}
+
+	// Drop the time that couldn't be simulated, running it later would only make the next frame longer.
+	if (physics_time_accumulator >= fixed_delta)
+		physics_time_accumulator = std::fmod(physics_time_accumulator, fixed_delta);
+}
+
+void SceneTree::_update_physics_interpolation_fraction(const long time_now) {
+	const double fixed_delta = physics_loop.get_step_time();
+	const double time_since_step = static_cast<double>(time_now - physics_loop.prev_step_time) / std::nano::den;
+
+	if (physics_loop.paused || fixed_delta <= 0.0) {
+		physics_interpolation_fraction = 1.0;
 		return;
+	}
+
+	physics_interpolation_fraction = std::clamp((physics_time_accumulator + time_since_step) / fixed_delta, 0.0, 1.0);
+}
+
+void SceneTree::_step_loop(Loop &loop, const long time_now) {
+	const long step_time = static_cast<long>(loop.get_step_time() * std::nano::den);
+	const double true_delta = static_cast<double>(time_now - loop.prev_step_time) / std::nano::den;
+	const double overshoot = static_cast<double>(time_now - loop.next_step_time) / std::nano::den;
+
+	loop._update_pacing_stats(true_delta, overshoot);
 
 	switch (loop.loop_type) {
 		case Loop::LOOP_TYPE_RENDER:
@@ -160,9 +517,13 @@ void SceneTree::_do_loop(Loop &loop) {
 			break;
 		case Loop::LOOP_TYPE_PROCESS:
 			step_process(true_delta);
+
+			// No render step follows while the render loop is paused or skipped, so the frame ends with the process step instead.
+			if (!_should_render())
+				_end_node_timing_frame();
 			break;
 		case Loop::LOOP_TYPE_PHYSICS:
-			step_physics(true_delta);
+			_step_physics_fixed(true_delta);
 			break;
 		default:
 			break;
@@ -170,38 +531,128 @@ void SceneTree::_do_loop(Loop &loop) {
 
 	loop.prev_step_time = time_now;
 	loop.step_count++;
+
+	// Advance from the deadline instead of the current time so the error of one step doesn't carry over to the next.
+	loop.next_step_time += step_time;
+	if (loop.next_step_time <= time_now)
+		loop.next_step_time = time_now + step_time;
+}
+
+void SceneTree::step(const natural steps, const double fixed_delta) {
+	for (natural i = 0; i < steps && !paused; i++) {
+		if (!process_loop.paused) {
+			step_process(fixed_delta);
+			process_loop.step_count++;
+		}
+
+		#ifdef TOOF_PHYSICS_ENABLED
+		if (!physics_loop.paused) {
+			_step_physics_fixed(fixed_delta);
+			_update_physics_interpolation_fraction(physics_loop.prev_step_time);
+			physics_loop.step_count++;
+		}
+		#endif
+
+		_end_node_timing_frame();
+	}
 }
 
 void SceneTree::queue_free(Node *node) {
+	std::lock_guard<std::mutex> lock(deferred_item_removal_mutex);
 	deferred_item_removal.push_back(node);
 }
 
+bool SceneTree::_should_render() const {
+	return !headless && !render_loop.paused && (!low_processor_mode || rendering_server->is_redraw_needed());
+}
+
+bool SceneTree::_is_loop_active(const Loop &loop) const {
+	switch (loop.loop_type) {
+		case Loop::LOOP_TYPE_RENDER:
+			return _should_render();
+		#ifdef TOOF_PHYSICS_ENABLED
+		case Loop::LOOP_TYPE_PHYSICS:
+		#endif
+		case Loop::LOOP_TYPE_PROCESS:
+			return !loop.paused;
+		default:
+			return false;
+	}
+}
+
+long SceneTree::_get_next_deadline(const long time_now) {
+	long next_deadline = -1;
+
+	for (Loop *loop: {&render_loop, &process_loop, &physics_loop}) {
+		// Inactive loops are kept due so they step right away once they become active again.
+		if (!_is_loop_active(*loop)) {
+			loop->next_step_time = std::max(loop->next_step_time, time_now);
+
+			if (loop->loop_type == Loop::LOOP_TYPE_RENDER && !headless)
+				rendering_server->skip_next_frame_time();
+			continue;
+		}
+
+		if (next_deadline < 0 || loop->next_step_time < next_deadline)
+			next_deadline = loop->next_step_time;
+	}
+
+	return next_deadline;
+}
+
+// Sleeping is only accurate to about a millisecond, so the last part of the wait is spent spinning.
+static constexpr long SPIN_TIME = 2 * (std::nano::den / std::milli::den);
+
+void SceneTree::_wait_until(const long deadline) {
+	// A headless SceneTree has no window to receive events from.
+	const bool wait_for_events = !event_paused && !headless;
+
+	if (deadline < 0) {
+		if (!wait_for_events)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		else if (SDL_WaitEvent(event.get()))
+			step_event();
+		return;
+	}
+
+	const long sleep_time = deadline - get_time_now() - SPIN_TIME;
+
+	if (sleep_time > 0) {
+		if (!wait_for_events)
+			std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_time));
+		else if (SDL_WaitEventTimeout(event.get(), static_cast<int>(sleep_time / (std::nano::den / std::milli::den)))) {
+			// The event may have changed the deadlines, like requesting a redraw in low processor mode.
+			step_event();
+			return;
+		}
+	}
+
+	while (running && get_time_now() < deadline)
+		std::this_thread::yield();
+}
+
 void SceneTree::_main_loop() {
 	while (running) {
 		if (paused)
 			return;
 
-		if (!event_paused)
+		if (!event_paused && !headless)
 			while (SDL_PollEvent(event.get()))
 				step_event();
 
-		if (!render_loop.paused)
-			_do_loop(render_loop);
-
-		if (!process_loop.paused)
-			_do_loop(process_loop);
-
-		#ifdef TOOF_PHYSICS_ENABLED
-		if (!physics_loop.paused)
-			_do_loop(physics_loop);
-		#endif
-
-		std::this_thread::yield();
+		step_loops(get_time_now());
+		_wait_until(_get_next_deadline(get_time_now()));
 	}
 }
 
+void SceneTree::step_loops(const long time_now) {
+	for (Loop *loop: {&render_loop, &process_loop, &physics_loop})
+		if (_is_loop_active(*loop) && time_now >= loop->next_step_time)
+			_step_loop(*loop, time_now);
+}
+
 void SceneTree::start() {
-	if (!window->intialized_successfully() || running)
+	if ((!headless && !window->intialized_successfully()) || running)
 		return;
 
 	running = true;
@@ -33,10 +33,20 @@
 #pragma once
 
 #include <core/memory/signal.hpp>
+#include <core/math/math_defs.hpp>
+#include <scene/main/process_list.hpp>
+#include <scene/main/node_pool.hpp>
+#include <scene/main/node_group.hpp>
+#include <scene/main/node_timing.hpp>
 
 #include <SDL_events.h>
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
 
 namespace Toof {
 
@@ -47,6 +57,9 @@ class Window;
 class RenderingServer;
 class Viewport;
 class Input;
+class InputEventRef;
+class InputPlayer;
+class ThreadPool;
 
 #ifdef TOOF_PHYSICS_ENABLED
 class PhysicsServer2D;
@@ -67,13 +80,29 @@ public:
 		double speed_scale;
 		double time_scale;
 		long prev_step_time;
+		long next_step_time;
 		uint64_t step_count;
+		double jitter;
+		double last_overshoot;
+		double max_overshoot;
+		uint64_t missed_deadlines;
 		LoopType loop_type = LOOP_TYPE_NONE;
 		bool paused;
 
 		friend SceneTree;
 
-		constexpr Loop(): frame_rate(60.0), delta_time(0.0), speed_scale(1.0), time_scale(1.0), prev_step_time(0), step_count(0), loop_type(LOOP_TYPE_NONE), paused(false) {
+		constexpr Loop(): frame_rate(60.0), delta_time(0.0), speed_scale(1.0), time_scale(1.0), prev_step_time(0), next_step_time(0), step_count(0), jitter(0.0), last_overshoot(0.0), max_overshoot(0.0), missed_deadlines(0), loop_type(LOOP_TYPE_NONE), paused(false) {
+		}
+
+		constexpr void _update_pacing_stats(const double step_delta, const double overshoot) {
+			const double step_error = step_delta > get_step_time() ? step_delta - get_step_time() : get_step_time() - step_delta;
+
+			jitter += (step_error - jitter) * 0.1;
+			last_overshoot = overshoot;
+			max_overshoot = overshoot > max_overshoot ? overshoot : max_overshoot;
+
+			if (overshoot >= get_step_time())
+				missed_deadlines++;
 		}
 	public:
 		~Loop() = default;
@@ -110,6 +139,56 @@ public:
 			return step_count;
 		}
 
+		/**
+		* @brief Returns the time in nanoseconds at which the loop steps next, see @b SceneTree::step_loops.
+		*/
+		constexpr long get_next_step_time() const {
+			return next_step_time;
+		}
+
+		/**
+		* @brief Returns the time in seconds between two steps of this loop.
+		*/
+		constexpr double get_step_time() const {
+			return speed_scale / frame_rate;
+		}
+
+		/**
+		* @brief Returns the smoothed difference in seconds between the time between two steps and the step time.
+		*/
+		constexpr double get_jitter() const {
+			return jitter;
+		}
+
+		/**
+		* @brief Returns how late in seconds the last step ran after its deadline.
+		*/
+		constexpr double get_last_overshoot() const {
+			return last_overshoot;
+		}
+
+		/**
+		* @brief Returns the highest overshoot in seconds since the pacing statistics were reset.
+		*/
+		constexpr double get_max_overshoot() const {
+			return max_overshoot;
+		}
+
+		/**
+		* @brief Returns the amount of steps that ran a whole step time or more after their deadline.
+		* @details The deadline of a loop that misses a step is moved forward instead of running the missed steps in a burst.
+		*/
+		constexpr uint64_t get_missed_deadlines() const {
+			return missed_deadlines;
+		}
+
+		constexpr void reset_pacing_stats() {
+			jitter = 0.0;
+			last_overshoot = 0.0;
+			max_overshoot = 0.0;
+			missed_deadlines = 0;
+		}
+
 		constexpr void set_paused(bool is_paused) {
 			paused = is_paused;
 		}
@@ -127,21 +206,56 @@ public:
 		}
 	};
 private:
-	bool running, paused, event_paused;
+	bool running, paused, event_paused, low_processor_mode, headless, node_timing_enabled, input_handled;
+	double node_time_budget;
+	double physics_time_accumulator;
+	double physics_interpolation_fraction;
+	natural max_physics_substeps;
 
 	Loop render_loop;
 	Loop process_loop;
 	Loop physics_loop;
 
-	void _step_loop(const Loop::LoopType loop_type);
-	void _do_loop(Loop &loop);
+	void _step_loop(Loop &loop, const long time_now);
+	void _step_physics_fixed(const double delta);
+	void _update_physics_interpolation_fraction(const long time_now);
+	void _create_process_group(const natural thread_group);
+	detail::ProcessGroup &_get_process_group(const natural thread_group);
+	detail::NodeGroup &_get_group(const StringName &group);
+	detail::NodeGroup *_find_group(const StringName &group);
+	const detail::NodeGroup *_find_group(const StringName &group) const;
+	ThreadPool &_get_thread_pool();
+	void _step_process_groups(const detail::ProcessCallback callback, const int what);
+	void _flush_deferred_calls();
+	void _update_tree_order();
+	void _collect_node_timings(const detail::ProcessCallback callback);
+	void _end_node_timing_frame();
+	void _push_coalesced_input_events();
+	void _play_input_frame();
+	NodePool &_get_node_pool(const std::type_index &type, Node *(*create_function)());
 	void _main_loop();
+	bool _should_render() const;
+	bool _is_loop_active(const Loop &loop) const;
+	long _get_next_deadline(const long time_now);
+	void _wait_until(const long deadline);
 
 	std::vector<Node*> deferred_item_removal;
+	std::mutex deferred_item_removal_mutex;
+	detail::ProcessGroup main_process_group;
+	std::map<natural, detail::ProcessGroup> thread_process_groups;
+	std::vector<detail::ProcessGroup*> thread_process_group_list;
+	std::unique_ptr<ThreadPool> thread_pool;
+	std::unordered_map<std::type_index, std::unique_ptr<NodePool>> node_pools;
+	std::unordered_map<StringName, detail::NodeGroup> groups;
+	std::unordered_map<std::type_index, std::array<detail::TimingStats, detail::PROCESS_CALLBACK_MAX>> type_timings;
+	std::array<int64_t, detail::PROCESS_CALLBACK_MAX> frame_callback_times;
+	uint64_t tree_order_counter;
+	bool tree_order_dirty;
 
 	std::unique_ptr<Window> window;
 	std::unique_ptr<Viewport> viewport;
 	std::unique_ptr<Input> input;
+	InputPlayer *input_player;
 	std::unique_ptr<RenderingServer> rendering_server;
 	std::unique_ptr<SDL_Event> event;
 	std::unique_ptr<Node> root;
@@ -152,17 +266,37 @@ private:
 
 	virtual void _initialize();
 	virtual void _ended();
+
+	friend Node;
 protected:
 	void _add_child(Node *child);
 public:
-	SceneTree();
+	/**
+	* @brief Creates the SceneTree with a Window, Viewport and RenderingServer, or without them if @b headless is true.
+	* @details A headless SceneTree still processes nodes and physics, but never renders or polls events.
+	* CanvasNodes inside a headless SceneTree have no canvas item. Useful for dedicated servers and tests, see @b step.
+	*/
+	explicit SceneTree(const bool headless = false);
 	virtual ~SceneTree();
 
 	Signal<> process_frame;
 	Signal<> render_frame;
-	Signal<> deferred_signals;
 	Signal<> physics_frame;
 
+	/**
+	* @brief Emitted after a frame in which the process, physics and render callbacks of the nodes together took longer than the node time budget.
+	* @details Receives the notification that took the longest in the frame, like @b Node::NOTIFICATION_PROCESS, and the nodes that took the longest, slowest first.
+	* A frame ends after the render step, after every step of @b step, or after every process step while the tree doesn't render,
+	* like headless trees, a paused render loop or low processor mode without a redraw.
+	* @see @b set_node_time_budget.
+	*/
+	Signal<int, const std::vector<NodeTimeReport>&> node_time_budget_exceeded;
+
+	/**
+	* @brief The maximum amount of nodes passed to @b node_time_budget_exceeded.
+	*/
+	static constexpr natural NODE_TIME_BUDGET_OFFENDERS = 5;
+
 	constexpr const std::unique_ptr<Window> &get_window() const {
 		return window;
 	}
@@ -201,8 +335,134 @@ public:
 	void step_event();
 	void step_physics(const double delta);
 
+	/**
+	* @brief Steps every active loop whose next step time is at or before @b time_now, like one iteration of the main loop.
+	* @details @b time_now is in nanoseconds, on the clock of @b Loop::get_next_step_time. Useful to drive the tree from another main loop.
+	* A loop that is a whole step or more behind steps once and continues a step time after @b time_now, instead of catching up.
+	*/
+	void step_loops(const long time_now);
+
+	/**
+	* @brief Sends @b input_event to the nodes processing input, in reverse tree order, until one of them calls @b set_input_as_handled.
+	* @details Nodes with a higher process priority receive the event first. @b step_event calls this for every event from SDL.
+	*/
+	void push_input_event(const InputEventRef input_event);
+
+	/**
+	* @brief Processes @b sdl_event with the Input of the tree and sends the resulting InputEvent like an event received from SDL.
+	* @details Mouse motion and controller axis events may be merged and sent later, see @b Input::set_coalescing_enabled.
+	*/
+	void push_sdl_event(const SDL_Event *sdl_event);
+
+	/**
+	* @brief Stops the propagation of the input event currently being sent, the remaining nodes don't receive it.
+	*/
+	constexpr void set_input_as_handled() {
+		input_handled = true;
+	}
+
+	constexpr bool is_input_handled() const {
+		return input_handled;
+	}
+
+	/**
+	* @brief Plays back the input events of @b player, or stops playing back if @b player is nullptr.
+	* @details At the start of every process step the events recorded for that process frame are processed and pushed, while input events from SDL are ignored.
+	* Together with @b step this replays a recording identically, regardless of how fast the steps run.
+	* @see @b Input::set_recorder.
+	*/
+	constexpr void set_input_player(InputPlayer *player) {
+		input_player = player;
+	}
+
+	constexpr InputPlayer *get_input_player() const {
+		return input_player;
+	}
+
+	/**
+	* @brief Runs @b steps process steps right away, each @b fixed_delta seconds long, together with the physics steps that fit in that time.
+	* @details Doesn't wait between steps and doesn't render, so it can simulate a lot faster than real time.
+	* The result only depends on @b steps and @b fixed_delta, not on how long the steps took. Paused loops are skipped. The physics interpolation fraction is set from the physics time left after each step.
+	* @note At most @b get_max_physics_substeps physics steps run per step. If @b fixed_delta is longer than that many physics steps,
+	* the rest of the time is dropped and physics falls behind the process loop, raise the limit with @b set_max_physics_substeps to avoid that.
+	*/
+	void step(const natural steps, const double fixed_delta);
+
+	/**
+	* @brief Deletes @b node, or returns it to its pool, at the end of the current process step. Safe to call from any thread.
+	* @see @b Node::queue_free.
+	*/
 	void queue_free(Node *node);
 
+	/**
+	* @brief Returns the NodePool for nodes of type @b T, creating it if it doesn't exist yet.
+	* @details The pools are owned by the SceneTree and delete the nodes they hold when the SceneTree is deleted.
+	*/
+	template<class T>
+	NodePool &get_node_pool() {
+		return _get_node_pool(typeid(T), []() -> Node* {
+			return new T();
+		});
+	}
+
+	/**
+	* @brief Takes a node of type @b T from its pool, see @b NodePool::acquire.
+	*/
+	template<class T>
+	T *acquire_node(Node *parent = nullptr) {
+		return static_cast<T*>(get_node_pool<T>().acquire(parent));
+	}
+
+	/**
+	* @brief Calls @b function on the main thread after the current process or physics step. Safe to call from any thread.
+	* @see @b Node::call_deferred.
+	*/
+	template<class F>
+	void call_deferred(F &&function) {
+		main_process_group.deferred_calls.push(std::forward<F>(function));
+	}
+
+	/**
+	* @brief Calls @b function with every node in @b group.
+	* @details Nodes can safely be added to or removed from the group by @b function, nodes removed during the call are skipped.
+	* The order is the order the nodes were added in, until a node is removed: the last node of the group is moved in its place.
+	*/
+	template<class F>
+	void call_group(const StringName &group, const F &function) {
+		if (detail::NodeGroup *node_group = _find_group(group))
+			node_group->for_each(function);
+	}
+
+	/**
+	* @brief Calls @b method with @b args on every node in @b group that is of type @b T.
+	*/
+	template<class T, class... MethodArgs, class... Args>
+	void call_group(const StringName &group, void (T::*method)(MethodArgs...), Args&&... args) {
+		call_group(group, [method, &args...](Node *node) {
+			if (T *object = dynamic_cast<T*>(node))
+				(object->*method)(args...);
+		});
+	}
+
+	/**
+	* @brief Calls @b function with every node in @b group, split over the threads of the thread pool.
+	* @details Returns once @b function returned for every node. @b function must be thread-safe and must not add
+	* nodes to or remove nodes from the group; use @b Node::call_deferred for that instead.
+	*/
+	void call_group_parallel(const StringName &group, const std::function<void(Node*)> &function);
+
+	/**
+	* @brief Sends the notification @b what to every node in @b group.
+	*/
+	void notify_group(const StringName &group, const int what);
+
+	/**
+	* @brief Returns the nodes in @b group that are inside the tree.
+	*/
+	std::vector<Node*> get_nodes_in_group(const StringName &group) const;
+	natural get_group_node_count(const StringName &group) const;
+	bool has_group(const StringName &group) const;
+
  	constexpr Loop &get_render_loop() & {
 		return render_loop;
 	}
@@ -231,6 +491,55 @@ public:
 		return paused;
 	}
 
+	/**
+	* @brief If true, the time each node spends in its process, physics process and render callbacks is measured.
+	* @details Adds two clock reads to each callback, so it is disabled by default.
+	* @see @b get_node_timing, @b get_type_timing and @b set_node_time_budget.
+	*/
+	constexpr void set_node_timing_enabled(const bool enabled) {
+		node_timing_enabled = enabled;
+	}
+
+	constexpr bool is_node_timing_enabled() const {
+		return node_timing_enabled;
+	}
+
+	/**
+	* @brief Sets the time in seconds the node callbacks may take together in one frame before @b node_time_budget_exceeded is emitted.
+	* @details A budget of 0 disables the signal. Only has an effect while node timing is enabled.
+	*/
+	constexpr void set_node_time_budget(const double budget) {
+		node_time_budget = budget;
+	}
+
+	constexpr double get_node_time_budget() const {
+		return node_time_budget;
+	}
+
+	/**
+	* @brief Returns how long the callback of @b node for the notification @b what took per step.
+	* @details @b what is @b Node::NOTIFICATION_PROCESS, @b Node::NOTIFICATION_PHYSICS_PROCESS or @b Node::NOTIFICATION_RENDER.
+	* The physics process time includes @b Node::NOTIFICATION_POST_PHYSICS_PROCESS.
+	*/
+	CallbackTiming get_node_timing(const Node *node, const int what) const;
+
+	/**
+	* @brief Returns how long the callbacks of all nodes of @b type together took per step, see @b get_node_timing.
+	*/
+	CallbackTiming get_type_timing(const std::type_index &type, const int what) const;
+
+	template<class T>
+	CallbackTiming get_type_timing(const int what) const {
+		return get_type_timing(typeid(T), what);
+	}
+
+	/**
+	* @brief Returns @b true if the SceneTree was created without a Window, Viewport and RenderingServer.
+	*/
+	constexpr bool is_headless() const {
+		return headless;
+	}
+
 	constexpr void set_event_paused(const bool paused) {
 		event_paused = paused;
 	}
@@ -239,6 +548,50 @@ public:
 		return event_paused;
 	}
 
+	/**
+	* @brief If true, frames are only rendered when something changed, and the main loop sleeps until the next event or process step.
+	* @details A frame is rendered after a canvas item, texture or the canvas transform changed, or after an event is received.
+	* The render step, including NOTIFICATION_RENDER, is skipped for frames identical to the previous one.
+	* Useful for applications that are mostly idle, as it avoids using a whole CPU core.
+	* @see @b RenderingServer::request_redraw.
+	*/
+	constexpr void set_low_processor_mode(const bool enabled) {
+		low_processor_mode = enabled;
+	}
+
+	constexpr bool is_low_processor_mode() const {
+		return low_processor_mode;
+	}
+
+	/**
+	* @brief Sets the maximum amount of physics steps that can run to catch up with a single physics loop step.
+	* @details Physics always steps with the fixed step time of the physics loop. Time that is left over after
+	* running @b max_substeps steps is dropped, so a long frame slows the simulation down instead of stalling the following frames.
+	*/
+	constexpr void set_max_physics_substeps(const natural max_substeps) {
+		max_physics_substeps = max_substeps;
+	}
+
+	constexpr natural get_max_physics_substeps() const {
+		return max_physics_substeps;
+	}
+
+	/**
+	* @brief Returns how far the current render step is between the previous and the next physics step, from 0.0 to 1.0.
+	* @details Used to interpolate between the two last physics transforms when rendering, see @b Node2D::set_physics_interpolation_enabled.
+	*/
+	constexpr double get_physics_interpolation_fraction() const {
+		return physics_interpolation_fraction;
+	}
+
+	/**
+	* @brief Returns the time in seconds that passed since the last physics step, which the next physics step simulates.
+	* @details Always shorter than the physics step time, longer times are dropped, see @b set_max_physics_substeps.
+	*/
+	constexpr double get_physics_time_accumulator() const {
+		return physics_time_accumulator;
+	}
+
 	#ifdef TOOF_PHYSICS_ENABLED
 
 	constexpr Loop &get_physics_loop() & {
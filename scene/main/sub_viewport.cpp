@@ -0,0 +1,147 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/main/sub_viewport.hpp>
+#include <scene/resources/viewport_texture.hpp>
+
+using namespace Toof;
+
+SubViewport::SubViewport(): sub_viewport(0),
+    size(512, 512),
+    canvas_transform(Transform2D::IDENTITY),
+    clear_color(0, 0, 0, 0),
+    update_mode(RenderingServer::SUB_VIEWPORT_UPDATE_ALWAYS),
+    update_interval(1),
+    texture(std::make_shared<ViewportTexture>()) {
+}
+
+void SubViewport::_create_sub_viewport() {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	if (!rendering_server)
+		return;
+
+	RenderingServer *server = rendering_server.get_value();
+	sub_viewport = server->create_sub_viewport(size).value_or(0);
+
+	server->sub_viewport_set_canvas_transform(sub_viewport, canvas_transform);
+	server->sub_viewport_set_clear_color(sub_viewport, clear_color);
+	server->sub_viewport_set_update_mode(sub_viewport, update_mode);
+	server->sub_viewport_set_update_interval(sub_viewport, update_interval);
+	server->canvas_item_set_sub_viewport(get_canvas_item(), sub_viewport);
+
+	texture->add_rendering_server_user(server);
+	texture->set_viewport_uid(sub_viewport);
+}
+
+void SubViewport::_remove_sub_viewport() {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	if (rendering_server)
+		rendering_server.get_value()->remove_uid(sub_viewport);
+
+	sub_viewport = 0;
+	texture->set_viewport_uid(0);
+	texture->remove_rendering_server_user(rendering_server.value_or(nullptr));
+}
+
+void SubViewport::_detach_from_parent_canvas_item() {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	if (rendering_server)
+		rendering_server.get_value()->canvas_item_set_parent(get_canvas_item(), 0);
+}
+
+void SubViewport::_notification(const int what) {
+	CanvasNode::_notification(what);
+
+	switch (what) {
+		case NOTIFICATION_ENTER_TREE:
+			_detach_from_parent_canvas_item();
+			_create_sub_viewport();
+			break;
+		case NOTIFICATION_EXIT_TREE:
+			_remove_sub_viewport();
+			break;
+		case NOTIFICATION_PARENTED:
+			_detach_from_parent_canvas_item();
+			break;
+		default:
+			break;
+	}
+}
+
+void SubViewport::set_size(const Vector2i &new_size) {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	size = new_size;
+
+	if (rendering_server)
+		rendering_server.get_value()->sub_viewport_set_size(sub_viewport, size);
+}
+
+void SubViewport::set_canvas_transform(const Transform2D &new_canvas_transform) {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	canvas_transform = new_canvas_transform;
+
+	if (rendering_server)
+		rendering_server.get_value()->sub_viewport_set_canvas_transform(sub_viewport, canvas_transform);
+}
+
+void SubViewport::set_clear_color(const ColorV &new_clear_color) {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	clear_color = new_clear_color;
+
+	if (rendering_server)
+		rendering_server.get_value()->sub_viewport_set_clear_color(sub_viewport, clear_color);
+}
+
+void SubViewport::set_update_mode(const RenderingServer::SubViewportUpdateMode new_update_mode) {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	update_mode = new_update_mode;
+
+	if (rendering_server)
+		rendering_server.get_value()->sub_viewport_set_update_mode(sub_viewport, update_mode);
+}
+
+void SubViewport::set_update_interval(const natural new_update_interval) {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+	update_interval = new_update_interval;
+
+	if (rendering_server)
+		rendering_server.get_value()->sub_viewport_set_update_interval(sub_viewport, update_interval);
+}
+
+void SubViewport::queue_update() {
+	Optional<RenderingServer*> rendering_server = get_rendering_server();
+
+	if (rendering_server)
+		rendering_server.get_value()->sub_viewport_queue_update(sub_viewport);
+}
@@ -0,0 +1,134 @@
+/*  This file is part of the Toof Engine. */
+/** @file sub_viewport.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <scene/main/canvas_node.hpp>
+#include <servers/rendering_server.hpp>
+
+namespace Toof {
+
+class ViewportTexture;
+
+/**
+* @brief Renders its descendant CanvasNodes into a texture instead of the window.
+* @details Useful for minimaps, portals and picture-in-picture views. The output is drawn with @b get_texture, for example by a Sprite2D.
+* The descendants are drawn with the canvas transform of the SubViewport and are not affected by the transform of the SubViewport's parent.
+* The texture can be refreshed less often than the main viewport with @b set_update_mode and @b set_update_interval.
+*/
+class SubViewport : public CanvasNode {
+private:
+	uid sub_viewport;
+	Vector2i size;
+	Transform2D canvas_transform;
+	ColorV clear_color;
+	RenderingServer::SubViewportUpdateMode update_mode;
+	natural update_interval;
+	std::shared_ptr<ViewportTexture> texture;
+
+	void _create_sub_viewport();
+	void _remove_sub_viewport();
+	void _detach_from_parent_canvas_item();
+protected:
+	void _notification(const int what) override;
+public:
+	SubViewport();
+	~SubViewport() = default;
+
+	/**
+	* @brief Returns the uid of the sub viewport used by the RenderingServer, which is also the uid of its texture.
+	*/
+	constexpr uid get_sub_viewport() const {
+		return sub_viewport;
+	}
+
+	/**
+	* @brief Returns the texture containing the output of this SubViewport.
+	* @note The texture is empty until the SubViewport is inside the SceneTree.
+	*/
+	const std::shared_ptr<ViewportTexture> &get_texture() const {
+		return texture;
+	}
+
+	/**
+	* @brief Sets the size of the texture this SubViewport renders into.
+	*/
+	void set_size(const Vector2i &new_size);
+
+	constexpr const Vector2i &get_size() const {
+		return size;
+	}
+
+	/**
+	* @brief Sets the transform applied to all descendants, like the canvas transform of the main viewport.
+	*/
+	void set_canvas_transform(const Transform2D &new_canvas_transform);
+
+	constexpr const Transform2D &get_canvas_transform() const {
+		return canvas_transform;
+	}
+
+	/**
+	* @brief Sets the color the texture is cleared with before rendering. Transparent by default.
+	*/
+	void set_clear_color(const ColorV &new_clear_color);
+
+	constexpr const ColorV &get_clear_color() const {
+		return clear_color;
+	}
+
+	/**
+	* @see @b RenderingServer::SubViewportUpdateMode.
+	*/
+	void set_update_mode(const RenderingServer::SubViewportUpdateMode new_update_mode);
+
+	constexpr RenderingServer::SubViewportUpdateMode get_update_mode() const {
+		return update_mode;
+	}
+
+	/**
+	* @brief Renders the SubViewport at most once every @b new_update_interval frames.
+	* @see @b RenderingServer::sub_viewport_set_update_interval.
+	*/
+	void set_update_interval(const natural new_update_interval);
+
+	constexpr natural get_update_interval() const {
+		return update_interval;
+	}
+
+	/**
+	* @brief Marks the SubViewport as dirty, which renders it on the next update with RenderingServer::SUB_VIEWPORT_UPDATE_WHEN_DIRTY.
+	*/
+	void queue_update();
+};
+
+}
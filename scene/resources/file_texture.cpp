@@ -34,19 +34,19 @@
 
 using namespace Toof;
 
-FileTexture::FileTexture() {
+FileTexture::FileTexture(): texture_uid(0), mipmaps_enabled(false) {
 }
 
-FileTexture::FileTexture(RenderingServer *rendering_server) {
+FileTexture::FileTexture(RenderingServer *rendering_server): texture_uid(0), mipmaps_enabled(false) {
 	set_rendering_server(rendering_server);
 }
 
-FileTexture::FileTexture(RenderingServer *rendering_server, const String &texture_path): texture_uid(0), texture_path(texture_path) {
+FileTexture::FileTexture(RenderingServer *rendering_server, const String &texture_path): texture_uid(0), texture_path(texture_path), mipmaps_enabled(false) {
 	set_rendering_server(rendering_server);
 	load_from_path(this->texture_path);
 }
 
-FileTexture::FileTexture(RenderingServer *rendering_server, String &&texture_path): texture_uid(), texture_path(std::move(texture_path)) {
+FileTexture::FileTexture(RenderingServer *rendering_server, String &&texture_path): texture_uid(0), texture_path(std::move(texture_path)), mipmaps_enabled(false) {
 	set_rendering_server(rendering_server);
 	load_from_path(this->texture_path);
 }
@@ -94,7 +94,7 @@ void FileTexture::_on_rendering_server_set() {
 	if (!get_rendering_server())
 		return;
 
-	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(texture_path);
+	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(texture_path, mipmaps_enabled);
 	texture_uid = text_uid.value_or(0);
 }
 
@@ -103,7 +103,7 @@ void FileTexture::load_from_path(const String &file_path) {
 	if (!get_rendering_server())
 		return;
 
-	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(file_path);
+	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(file_path, mipmaps_enabled);
 	texture_uid = text_uid.value_or(0);
 }
 
@@ -112,6 +112,19 @@ void FileTexture::load_from_path(String &&file_path) {
 	if (!get_rendering_server())
 		return;
 
-	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(texture_path);
+	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(texture_path, mipmaps_enabled);
+	texture_uid = text_uid.value_or(0);
+}
+
+void FileTexture::set_mipmaps_enabled(const bool enabled) {
+	if (mipmaps_enabled == enabled)
+		return;
+
+	mipmaps_enabled = enabled;
+	if (!get_rendering_server() || !texture_uid)
+		return;
+
+	get_rendering_server()->remove_uid(texture_uid);
+	Optional<uid> text_uid = get_rendering_server()->load_texture_from_path(texture_path, mipmaps_enabled);
 	texture_uid = text_uid.value_or(0);
 }
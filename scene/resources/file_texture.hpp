@@ -44,6 +44,7 @@ class FileTexture : public Texture2D {
 private:
 	uid texture_uid;
 	String texture_path;
+	bool mipmaps_enabled;
 
 	Vector2i _get_size() const override;
 
@@ -72,6 +73,17 @@ public:
 
 	void load_from_path(const String &file_path);
 	void load_from_path(String &&file_path);
+
+	/**
+	* @brief Generates downscaled variants of the texture that are drawn when the texture is displayed at half its size or smaller.
+	* Reduces aliasing and texture bandwidth when the texture is minified, at the cost of a third more texture memory.
+	* @note Reloads the texture if it was already loaded.
+	*/
+	void set_mipmaps_enabled(const bool enabled);
+
+	constexpr bool are_mipmaps_enabled() const {
+		return mipmaps_enabled;
+	}
 };
 
 }
@@ -0,0 +1,115 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/resources/image_texture.hpp>
+
+using namespace Toof;
+
+ImageTexture::ImageTexture(): texture_uid(0), size(), format(SDL_PIXELFORMAT_RGBA32) {
+}
+
+ImageTexture::ImageTexture(RenderingServer *rendering_server): texture_uid(0), size(), format(SDL_PIXELFORMAT_RGBA32) {
+	set_rendering_server(rendering_server);
+}
+
+ImageTexture::ImageTexture(RenderingServer *rendering_server, const Vector2i &size, const uint32_t format): texture_uid(0), size(size), format(format) {
+	set_rendering_server(rendering_server);
+}
+
+Vector2i ImageTexture::_get_size() const {
+	return size;
+}
+
+SDL_Texture *ImageTexture::_get_texture() const {
+	if (get_rendering_server()) {
+		Optional<RenderingServer::TextureInfo> texture_info = get_rendering_server()->get_texture_info_from_uid(texture_uid);
+		return texture_info ? texture_info->texture : nullptr;
+	}
+
+	return nullptr;
+}
+
+void ImageTexture::_draw(const uid texture_uid,
+	const uid canvas_item_uid,
+	const SDL_RendererFlip flip,
+	const ColorV &modulate,
+	const Transform2D &transform)
+{
+	if (get_rendering_server())
+		get_rendering_server()->canvas_item_add_texture(texture_uid, canvas_item_uid, flip, modulate, transform);
+}
+
+void ImageTexture::_draw_region(const uid texture_uid,
+	const uid canvas_item_uid,
+	const Rect2i &src_region,
+	const SDL_RendererFlip flip,
+	const ColorV &modulate,
+	const Transform2D &transform)
+{
+	if (get_rendering_server())
+		get_rendering_server()->canvas_item_add_texture_region(texture_uid, canvas_item_uid, src_region, flip, modulate, transform);
+}
+
+void ImageTexture::_on_rendering_server_set() {
+	texture_uid = 0;
+	if (get_rendering_server() && size.x > 0 && size.y > 0)
+		create(size, format);
+}
+
+void ImageTexture::create(const Vector2i &size, const uint32_t format) {
+	this->size = size;
+	this->format = format;
+	if (!get_rendering_server())
+		return;
+
+	if (texture_uid)
+		get_rendering_server()->remove_uid(texture_uid);
+
+	Optional<uid> text_uid = get_rendering_server()->create_texture(size, SDL_TEXTUREACCESS_STREAMING, format);
+	texture_uid = text_uid.value_or(0);
+}
+
+Optional<RenderingServer::TextureLock> ImageTexture::lock(const Rect2i &region) {
+	if (!get_rendering_server())
+		return NullOption;
+
+	return get_rendering_server()->texture_lock(texture_uid, region);
+}
+
+void ImageTexture::unlock() {
+	if (get_rendering_server())
+		get_rendering_server()->texture_unlock(texture_uid);
+}
+
+void ImageTexture::queue_update(const Rect2i &region, std::vector<uint8_t> &&pixels, const int pitch) {
+	if (get_rendering_server())
+		get_rendering_server()->texture_queue_update(texture_uid, region, std::move(pixels), pitch);
+}
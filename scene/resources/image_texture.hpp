@@ -0,0 +1,98 @@
+/*  This file is part of the Toof Engine. */
+/** @file image_texture.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <scene/resources/texture2d.hpp>
+#include <servers/rendering_server.hpp>
+
+namespace Toof {
+
+/**
+* @brief A texture whose pixels are written by the CPU, for procedural content, video frames and software rendered effects.
+* @details Backed by a SDL_TEXTUREACCESS_STREAMING texture. Pixels can be written directly into the texture memory with lock and unlock,
+* or from any thread with queue_update, which are uploaded by the RenderingServer at the start of the next render.
+*/
+class ImageTexture : public Texture2D {
+private:
+	uid texture_uid;
+	Vector2i size;
+	uint32_t format;
+
+	Vector2i _get_size() const override;
+
+	inline integer _get_width() const override {
+		return size.x;
+	}
+
+	inline integer _get_height() const override {
+		return size.y;
+	}
+
+	inline uid _get_uid() const override {
+		return texture_uid;
+	}
+
+	SDL_Texture *_get_texture() const override;
+	void _draw(const uid, const uid, const SDL_RendererFlip, const ColorV&, const Transform2D&) override;
+	void _draw_region(const uid, const uid, const Rect2i&, const SDL_RendererFlip, const ColorV&, const Transform2D&) override;
+protected:
+	void _on_rendering_server_set() override;
+public:
+	ImageTexture();
+	ImageTexture(RenderingServer *rendering_server);
+	ImageTexture(RenderingServer *rendering_server, const Vector2i &size, const uint32_t format = SDL_PIXELFORMAT_RGBA32);
+
+	/**
+	* @brief Creates the texture with the given @param size and pixel @param format, replacing the previous texture.
+	*/
+	void create(const Vector2i &size, const uint32_t format = SDL_PIXELFORMAT_RGBA32);
+
+	constexpr uint32_t get_format() const {
+		return format;
+	}
+
+	/**
+	* @brief Locks @param region of the texture for writing, or the whole texture if @param region is empty.
+	* @note Must be called from the thread that renders. Only the locked region is uploaded on unlock.
+	*/
+	Optional<RenderingServer::TextureLock> lock(const Rect2i &region = Rect2i());
+	void unlock();
+
+	/**
+	* @brief Copies @param pixels into @param region at the start of the next render. Safe to call from any thread.
+	* @details The buffer is moved into the RenderingServer, so a worker thread can fill a staging buffer without waiting on the render thread.
+	*/
+	void queue_update(const Rect2i &region, std::vector<uint8_t> &&pixels, const int pitch);
+};
+
+}
@@ -0,0 +1,350 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <scene/resources/packed_scene.hpp>
+#include <scene/resources/file_texture.hpp>
+#include <scene/main/scene_tree.hpp>
+#include <scene/2d/sprite2d.hpp>
+#include <servers/rendering_server.hpp>
+
+#include <cereal/archives/portable_binary.hpp>
+
+#include <sstream>
+#include <typeinfo>
+#include <unordered_map>
+
+#define TOOF_DETAIL_SAVE_NODE_TYPE(type) \
+if (typeid(node) == typeid(type)) { \
+	save_node_properties(archive, static_cast<const type&>(node)); \
+	return TOOF_RESOURCE_ID(type); }
+
+#define TOOF_DETAIL_LOAD_NODE_TYPE(type) \
+if (type_id == TOOF_RESOURCE_ID(type)) { \
+	auto node = new type(); \
+	load_node_properties(archive, *node, texture_cache); \
+	return node; }
+
+using namespace Toof;
+
+// The textures loaded by one instantiate call by path, so sprites using the same file share one texture.
+using TextureCache = std::unordered_map<String, std::shared_ptr<FileTexture>>;
+
+template<class Archive>
+static void save_node_properties(Archive &archive, const Node &node) {
+	archive(cereal::make_nvp("Name", node.get_name()));
+	archive(cereal::make_nvp("ProcessPriority", node.get_process_priority()));
+	archive(cereal::make_nvp("ProcessThreadGroup", node.get_process_thread_group()));
+	archive(cereal::make_nvp("Processing", node.is_processing()));
+	archive(cereal::make_nvp("PhysicsProcessing", node.is_physics_processing()));
+	archive(cereal::make_nvp("RenderProcessing", node.is_render_processing()));
+	archive(cereal::make_nvp("ProcessingInput", node.is_processing_input()));
+	archive(cereal::make_nvp("Groups", node.get_groups()));
+}
+
+template<class Archive>
+static void load_node_properties(Archive &archive, Node &node, TextureCache&) {
+	String name;
+	int process_priority;
+	natural process_thread_group;
+	bool processing, physics_processing, render_processing, processing_input;
+	std::vector<StringName> groups;
+
+	archive(cereal::make_nvp("Name", name));
+	archive(cereal::make_nvp("ProcessPriority", process_priority));
+	archive(cereal::make_nvp("ProcessThreadGroup", process_thread_group));
+	archive(cereal::make_nvp("Processing", processing));
+	archive(cereal::make_nvp("PhysicsProcessing", physics_processing));
+	archive(cereal::make_nvp("RenderProcessing", render_processing));
+	archive(cereal::make_nvp("ProcessingInput", processing_input));
+	archive(cereal::make_nvp("Groups", groups));
+
+	node.set_name(name);
+	node.set_process_priority(process_priority);
+	node.set_process_thread_group(process_thread_group);
+	node.set_process(processing);
+	node.set_physics_process(physics_processing);
+	node.set_render_process(render_processing);
+	node.set_process_input(processing_input);
+
+	for (const StringName &group: groups)
+		node.add_to_group(group);
+}
+
+template<class Archive>
+static void save_node_properties(Archive &archive, const CanvasNode &canvas_node) {
+	save_node_properties(archive, static_cast<const Node&>(canvas_node));
+
+	archive(cereal::make_nvp("Visible", canvas_node.is_visible()));
+	archive(cereal::make_nvp("Modulation", canvas_node.get_modulation()));
+	archive(cereal::make_nvp("BlendMode", canvas_node.get_blend_mode()));
+	archive(cereal::make_nvp("ScaleMode", canvas_node.get_scale_mode()));
+	archive(cereal::make_nvp("ZIndex", canvas_node.get_zindex()));
+	archive(cereal::make_nvp("ZIndexRelative", canvas_node.get_zindex_relative()));
+}
+
+template<class Archive>
+static void load_node_properties(Archive &archive, CanvasNode &canvas_node, TextureCache &texture_cache) {
+	load_node_properties(archive, static_cast<Node&>(canvas_node), texture_cache);
+
+	bool visible, zindex_relative;
+	ColorV modulation;
+	SDL_BlendMode blend_mode;
+	SDL_ScaleMode scale_mode;
+	int zindex;
+
+	archive(cereal::make_nvp("Visible", visible));
+	archive(cereal::make_nvp("Modulation", modulation));
+	archive(cereal::make_nvp("BlendMode", blend_mode));
+	archive(cereal::make_nvp("ScaleMode", scale_mode));
+	archive(cereal::make_nvp("ZIndex", zindex));
+	archive(cereal::make_nvp("ZIndexRelative", zindex_relative));
+
+	if (!visible)
+		canvas_node.hide();
+
+	canvas_node.set_modulation(modulation);
+	canvas_node.set_blend_mode(blend_mode);
+	canvas_node.set_scale_mode(scale_mode);
+	canvas_node.set_zindex(zindex);
+	canvas_node.set_zindex_relative(zindex_relative);
+}
+
+template<class Archive>
+static void save_node_properties(Archive &archive, const Node2D &node2d) {
+	save_node_properties(archive, static_cast<const CanvasNode&>(node2d));
+
+	archive(cereal::make_nvp("Transform", node2d.get_transform()));
+	archive(cereal::make_nvp("PhysicsInterpolation", node2d.is_physics_interpolation_enabled()));
+}
+
+template<class Archive>
+static void load_node_properties(Archive &archive, Node2D &node2d, TextureCache &texture_cache) {
+	load_node_properties(archive, static_cast<CanvasNode&>(node2d), texture_cache);
+
+	Transform2D transform;
+	bool physics_interpolation_enabled;
+
+	archive(cereal::make_nvp("Transform", transform));
+	archive(cereal::make_nvp("PhysicsInterpolation", physics_interpolation_enabled));
+
+	node2d.set_transform(transform);
+	node2d.set_physics_interpolation_enabled(physics_interpolation_enabled);
+}
+
+template<class Archive>
+static void save_node_properties(Archive &archive, const Sprite2D &sprite) {
+	save_node_properties(archive, static_cast<const Node2D&>(sprite));
+
+	const FileTexture *file_texture = dynamic_cast<const FileTexture*>(sprite.get_texture().get());
+
+	archive(cereal::make_nvp("TexturePath", file_texture ? file_texture->get_texture_path() : String()));
+	archive(cereal::make_nvp("TextureRegion", sprite.get_texture_region()));
+	archive(cereal::make_nvp("TextureTransform", sprite.get_texture_transform()));
+	archive(cereal::make_nvp("Flip", sprite.get_flip()));
+	archive(cereal::make_nvp("Centered", sprite.is_centered()));
+}
+
+template<class Archive>
+static void load_node_properties(Archive &archive, Sprite2D &sprite, TextureCache &texture_cache) {
+	load_node_properties(archive, static_cast<Node2D&>(sprite), texture_cache);
+
+	String texture_path;
+	Rect2i texture_region;
+	Transform2D texture_transform;
+	SDL_RendererFlip flip;
+	bool centered;
+
+	archive(cereal::make_nvp("TexturePath", texture_path));
+	archive(cereal::make_nvp("TextureRegion", texture_region));
+	archive(cereal::make_nvp("TextureTransform", texture_transform));
+	archive(cereal::make_nvp("Flip", flip));
+	archive(cereal::make_nvp("Centered", centered));
+
+	// The texture is loaded once the first sprite using it enters the tree and gets a RenderingServer.
+	if (!texture_path.empty()) {
+		std::shared_ptr<FileTexture> &texture = texture_cache[texture_path];
+		if (!texture) {
+			texture = std::make_shared<FileTexture>();
+			texture->load_from_path(std::move(texture_path));
+		}
+
+		sprite.set_texture(texture);
+	}
+
+	sprite.set_texture_region(texture_region);
+	sprite.set_texture_transform(texture_transform);
+	sprite.set_flip(flip);
+	sprite.set_centered(centered);
+}
+
+template<class Archive>
+static int32_t save_node(Archive &archive, const Node &node) {
+	// Derived types are compared first, the exact type of the node has to be known to load it again.
+	TOOF_DETAIL_SAVE_NODE_TYPE(Sprite2D)
+	TOOF_DETAIL_SAVE_NODE_TYPE(Node2D)
+	TOOF_DETAIL_SAVE_NODE_TYPE(CanvasNode)
+	TOOF_DETAIL_SAVE_NODE_TYPE(Node)
+
+	return TOOF_RESOURCE_ID(Resource);
+}
+
+template<class Archive>
+static Node *load_node(Archive &archive, const int32_t type_id, TextureCache &texture_cache) {
+	TOOF_DETAIL_LOAD_NODE_TYPE(Sprite2D)
+	TOOF_DETAIL_LOAD_NODE_TYPE(Node2D)
+	TOOF_DETAIL_LOAD_NODE_TYPE(CanvasNode)
+	TOOF_DETAIL_LOAD_NODE_TYPE(Node)
+
+	return nullptr;
+}
+
+bool PackedScene::pack(const Node *root) {
+	clear();
+	if (!root)
+		return false;
+
+	std::ostringstream stream = std::ostringstream(std::ios::binary);
+
+	{
+		cereal::PortableBinaryOutputArchive archive(stream);
+		std::vector<std::pair<const Node*, int64_t>> stack = {{root, -1}};
+
+		// Depth first, so the nodes are stored in tree order.
+		while (!stack.empty()) {
+			const auto [node, parent_index] = stack.back();
+			stack.pop_back();
+
+			const int32_t type_id = save_node(archive, *node);
+			if (type_id == TOOF_RESOURCE_ID(Resource)) {
+				clear();
+				return false;
+			}
+
+			const int64_t index = nodes.size();
+			nodes.push_back({type_id, parent_index});
+
+			for (natural i = node->get_child_count(); i > 0; i--)
+				stack.push_back({node->get_child(i - 1), index});
+		}
+	}
+
+	properties = stream.str();
+	return true;
+}
+
+Node *PackedScene::instantiate(Node *parent) const {
+	if (nodes.empty())
+		return nullptr;
+
+	std::istringstream stream = std::istringstream(properties, std::ios::binary);
+	cereal::PortableBinaryInputArchive archive(stream);
+
+	std::vector<Node*> instances;
+	instances.reserve(nodes.size());
+	TextureCache texture_cache;
+
+	for (natural i = 0; i < nodes.size(); i++) {
+		const int64_t parent_index = nodes[i].parent_index;
+		Node *node = load_node(archive, nodes[i].type_id, texture_cache);
+
+		// Only a corrupted scene has an unknown type, or a parent that isn't stored before its child.
+		if (!node || (i && (parent_index < 0 || parent_index >= static_cast<int64_t>(i)))) {
+			delete node;
+			for (natural j = instances.size(); j > 0; j--)
+				delete instances[j - 1];
+
+			return nullptr;
+		}
+
+		if (i) {
+			instances[parent_index]->_link_child(node);
+			node->notification(Node::NOTIFICATION_PARENTED);
+		}
+
+		instances.push_back(node);
+	}
+
+	if (parent && parent->is_inside_tree())
+		_enter_tree(instances, parent);
+	else if (parent)
+		parent->add_child(instances.front());
+
+	return instances.front();
+}
+
+void PackedScene::_enter_tree(const std::vector<Node*> &instances, Node *parent) const {
+	SceneTree *tree = parent->get_tree();
+	RenderingServer *rendering_server = tree->get_rendering_server().get();
+	std::vector<CanvasNode*> canvas_nodes;
+
+	for (Node *node: instances)
+		if (CanvasNode *canvas_node = dynamic_cast<CanvasNode*>(node))
+			canvas_nodes.push_back(canvas_node);
+
+	if (rendering_server) {
+		const std::vector<uid> canvas_items = rendering_server->create_canvas_items(canvas_nodes.size());
+		for (natural i = 0; i < canvas_nodes.size(); i++)
+			canvas_nodes[i]->canvas_item = canvas_items[i];
+	}
+
+	// Keeps every CanvasNode from queueing its own redraw when it enters the tree, they are all redrawn by one call instead.
+	for (CanvasNode *canvas_node: canvas_nodes)
+		canvas_node->update_queued = true;
+
+	Node *root = instances.front();
+	parent->_link_child(root);
+
+	for (Node *node: instances)
+		node->_attach_tree(tree);
+
+	root->_check_tree_order();
+
+	for (Node *node: instances)
+		node->notification(Node::NOTIFICATION_ENTER_TREE);
+
+	for (Node *node: instances)
+		node->_notify_ready();
+
+	root->notification(Node::NOTIFICATION_PARENTED);
+
+	if (!canvas_nodes.empty())
+		tree->call_deferred([canvas_nodes = std::move(canvas_nodes)]() {
+			for (CanvasNode *canvas_node: canvas_nodes) {
+				canvas_node->_update();
+				canvas_node->notification(CanvasNode::NOTIFICATION_DRAW);
+			}
+		});
+}
+
+void PackedScene::clear() {
+	nodes.clear();
+	properties.clear();
+}
@@ -0,0 +1,130 @@
+/*  This file is part of the Toof Engine. */
+/** @file packed_scene.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <scene/resources/resource.hpp>
+#include <scene/resources/resource_format_loader.hpp>
+#include <core/string/string_def.hpp>
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <vector>
+
+namespace Toof {
+
+class Node;
+class CanvasNode;
+class Node2D;
+class Sprite2D;
+class PackedScene;
+
+TOOF_DETAIL_RESOURCE_ID(PackedScene, 2000)
+TOOF_DETAIL_RESOURCE_ID(Node, 2001)
+TOOF_DETAIL_RESOURCE_ID(CanvasNode, 2002)
+TOOF_DETAIL_RESOURCE_ID(Node2D, 2003)
+TOOF_DETAIL_RESOURCE_ID(Sprite2D, 2004)
+
+namespace detail {
+
+struct PackedNode {
+	/**
+	* @brief The resource id of the type of the node.
+	*/
+	int32_t type_id;
+
+	/**
+	* @brief The index of the parent of the node in the PackedScene. The first node has no parent and stores -1.
+	*/
+	int64_t parent_index;
+
+	template<class Archive>
+	inline void serialize(Archive &archive) {
+		archive(cereal::make_nvp("TypeId", type_id));
+		archive(cereal::make_nvp("ParentIndex", parent_index));
+	}
+};
+
+}
+
+/**
+* @brief A tree of nodes stored as a flat array of records, which can be saved with cereal and instantiated many times.
+* @details The records are stored in tree order, so a parent always comes before its children.
+* The properties of all nodes are stored after each other in a single portable binary buffer, which is read in one pass when instantiating.
+* Only Node, CanvasNode, Node2D and Sprite2D can be packed. Textures of a Sprite2D are only packed if they are a FileTexture,
+* sprites of one instance that use the same file share one texture.
+*/
+class PackedScene : public Resource {
+	std::vector<detail::PackedNode> nodes;
+	String properties;
+
+	void _enter_tree(const std::vector<Node*> &instances, Node *parent) const;
+public:
+	PackedScene() = default;
+	~PackedScene() = default;
+
+	/**
+	* @brief Packs @b root and all its children, replacing the previously packed nodes.
+	* @returns @b false and leaves the PackedScene empty if any of the nodes is of a type that can't be packed.
+	*/
+	bool pack(const Node *root);
+
+	/**
+	* @brief Creates the packed nodes and returns the root of the new nodes, or @b nullptr if nothing is packed.
+	* @details If @b parent is inside the tree, the new nodes enter the tree as one batch: the canvas items of all nodes are
+	* created at once, all nodes receive NOTIFICATION_ENTER_TREE before any of them receives NOTIFICATION_READY, and
+	* the nodes are redrawn by a single deferred call. This is a lot faster than adding the nodes one by one.
+	*/
+	Node *instantiate(Node *parent = nullptr) const;
+
+	/**
+	* @brief Removes all packed nodes.
+	*/
+	void clear();
+
+	natural get_node_count() const {
+		return nodes.size();
+	}
+
+	bool is_empty() const {
+		return nodes.empty();
+	}
+
+	template<class Archive>
+	inline void serialize(Archive &archive) {
+		archive(cereal::make_nvp("Nodes", nodes));
+		archive(cereal::make_nvp("Properties", properties));
+	}
+};
+
+}
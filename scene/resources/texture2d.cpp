@@ -34,5 +34,5 @@
 
 using namespace Toof;
 
-Texture2D::Texture2D(): rendering_server(nullptr) {
+Texture2D::Texture2D(): rendering_server(nullptr), rendering_server_users(0) {
 }
@@ -49,6 +49,7 @@ class RenderingServer;
 class Texture2D : public Resource {
 private:
 	RenderingServer *rendering_server;
+	natural rendering_server_users;
 
 	virtual Vector2i _get_size() const {
 		return Vector2i();
@@ -83,11 +84,45 @@ protected:
 public:
 	~Texture2D() = default;
 
+	/**
+	* @brief Sets the RenderingServer the texture is loaded into. Does nothing if it is already set to @b rendering_server,
+	* so textures shared by several nodes are only loaded once.
+	*/
 	inline void set_rendering_server(RenderingServer *rendering_server) {
+		if (this->rendering_server == rendering_server)
+			return;
+
 		this->rendering_server = rendering_server;
+		rendering_server_users = 0;
 		_on_rendering_server_set();
 	}
 
+	/**
+	* @brief Loads the texture into @b rendering_server for a node drawing it, a texture drawn by several nodes is loaded once.
+	* @details The users are counted for the RenderingServer the texture is loaded into, a user of another RenderingServer moves the texture to it.
+	*/
+	inline void add_rendering_server_user(RenderingServer *rendering_server) {
+		set_rendering_server(rendering_server);
+		if (rendering_server)
+			rendering_server_users++;
+	}
+
+	/**
+	* @brief Removes a user added with @b add_rendering_server_user, the texture is unloaded from @b rendering_server when its last user is removed.
+	* Does nothing if the texture was moved to another RenderingServer since.
+	*/
+	inline void remove_rendering_server_user(RenderingServer *rendering_server) {
+		if (!rendering_server || this->rendering_server != rendering_server || !rendering_server_users)
+			return;
+
+		if (--rendering_server_users == 0)
+			set_rendering_server(nullptr);
+	}
+
+	constexpr natural get_rendering_server_users() const {
+		return rendering_server_users;
+	}
+
 	constexpr RenderingServer *get_rendering_server() {
 		return rendering_server;
 	}
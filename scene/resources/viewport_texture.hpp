@@ -0,0 +1,75 @@
+/*  This file is part of the Toof Engine. */
+/** @file viewport_texture.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <scene/resources/texture2d.hpp>
+
+namespace Toof {
+
+/**
+* @brief A texture that displays the output of a SubViewport.
+* @see SubViewport::get_texture.
+*/
+class ViewportTexture : public Texture2D {
+private:
+	uid viewport_uid;
+
+	Vector2i _get_size() const override;
+
+	inline integer _get_width() const override {
+		return _get_size().x;
+	}
+
+	inline integer _get_height() const override {
+		return _get_size().y;
+	}
+
+	inline uid _get_uid() const override {
+		return viewport_uid;
+	}
+
+	SDL_Texture *_get_texture() const override;
+	void _draw(const uid, const uid, const SDL_RendererFlip, const ColorV&, const Transform2D&) override;
+	void _draw_region(const uid, const uid, const Rect2i&, const SDL_RendererFlip, const ColorV&, const Transform2D&) override;
+public:
+	ViewportTexture();
+
+	/**
+	* @brief Sets the uid of the sub viewport to display, set by the SubViewport owning this texture.
+	*/
+	constexpr void set_viewport_uid(const uid new_viewport_uid) {
+		viewport_uid = new_viewport_uid;
+	}
+};
+
+}
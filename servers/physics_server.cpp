@@ -36,6 +36,7 @@
 #include <servers/physics/physics_shape.hpp>
 #include <servers/physics/physics_info.hpp>
 #include <servers/physics_server.hpp>
+#include <core/os/profiler.hpp>
 
 #include <box2d/b2_world.h>
 
@@ -117,6 +118,7 @@ Toof::PhysicsServer2D::~PhysicsServer2D() {
 }
 
 void Toof::PhysicsServer2D::tick(const double delta) {
+	TOOF_PROFILE_ZONE("PhysicsServer2D::tick");
 	for (const auto &iterator: worlds)
 		tick_world(iterator.second, delta);
 }
@@ -112,4 +112,23 @@ bool detail::CanvasItem::is_globally_visible() {
 int detail::CanvasItem::get_global_zindex() {
 	set_global_zindex();
 	return global_zindex;
-}
\ No newline at end of file
+}
+
+uid detail::CanvasItem::get_sub_viewport() const {
+	if (sub_viewport)
+		return sub_viewport;
+
+	std::shared_ptr<CanvasItem> parent_canvas_item = parent.lock();
+
+	while (parent_canvas_item) {
+		if (parent_canvas_item->sub_viewport)
+			return parent_canvas_item->sub_viewport;
+		parent_canvas_item = parent_canvas_item->parent.lock();
+	}
+
+	return 0;
+}
+
+void detail::CanvasItem::set_global_sub_viewport() {
+	global_sub_viewport = get_sub_viewport();
+}
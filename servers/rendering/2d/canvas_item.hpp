@@ -54,8 +54,11 @@ struct CanvasItem {
 	bool visible = true;
 	bool zindex_relative = true;
 	bool global_visible = true;
+	bool light = false;
 	int zindex = true;
 	int global_zindex = 0;
+	uid sub_viewport = 0;
+	uid global_sub_viewport = 0;
 
 	SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND;
 	SDL_ScaleMode scale_mode = SDL_ScaleModeLinear;
@@ -72,6 +75,16 @@ struct CanvasItem {
 	const ColorV &get_global_modulate();
 	bool is_globally_visible();
 	int get_global_zindex();
+
+	/**
+	* @brief Returns the uid of the sub viewport this CanvasItem or its closest ancestor is drawn into, or 0 if it's drawn into the main viewport.
+	*/
+	uid get_sub_viewport() const;
+
+	/**
+	* @brief Caches @b get_sub_viewport in @b global_sub_viewport, so the render passes of a frame don't walk the parents of every item again.
+	*/
+	void set_global_sub_viewport();
 };
 
 }
@@ -34,6 +34,9 @@
 #include <servers/rendering/viewport.hpp>
 #include <servers/rendering/texture.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace Toof;
 
 void detail::DrawingItem::draw(const std::shared_ptr<CanvasItem> &canvas_item, const Viewport *viewport) {
@@ -59,6 +62,14 @@ Toof::Rect2f detail::TextureDrawingItem::_get_draw_rect(const std::shared_ptr<Ca
 	return Rect2(position, size);
 }
 
+static const detail::Texture_Mipmap *get_texture_mipmap_for_scale(const std::shared_ptr<detail::Texture_Ref> &texture, const real scale) {
+	if (texture->mipmaps.empty() || scale <= 0.0 || scale > 0.5)
+		return nullptr;
+
+	const size_t level = std::min(static_cast<size_t>(std::floor(std::log2(1.0 / scale))), texture->mipmaps.size());
+	return &texture->mipmaps[level - 1];
+}
+
 void detail::TextureDrawingItem::_draw(const std::shared_ptr<CanvasItem> &canvas_item, const Viewport *viewport) {
 	if (texture.expired())
 		return;
@@ -67,24 +78,38 @@ void detail::TextureDrawingItem::_draw(const std::shared_ptr<CanvasItem> &canvas
 
 	const ColorV &modulate = texture_modulate * canvas_item->get_global_modulate();
 
-	SDL_SetTextureAlphaMod(texture->texture_reference, modulate.a);
-	SDL_SetTextureColorMod(texture->texture_reference, modulate.r, modulate.g, modulate.b);
-	SDL_SetTextureBlendMode(texture->texture_reference, canvas_item->blend_mode);
-	SDL_SetTextureScaleMode(texture->texture_reference, canvas_item->scale_mode);
-
 	const Transform2D &global_transform = canvas_item->get_global_transform() * viewport->get_canvas_transform();
 	const Rect2i &source_region = use_region ? src_region : Rect2i(Vector2i(), texture->size);
 	const Angle rotation = global_transform.rotation + transform.rotation;
 	Rect2f final_draw_rect = rect2f_add_transform(_get_draw_rect(canvas_item), viewport->get_canvas_transform());
 	final_draw_rect.rounded();
 
+	SDL_Texture *texture_reference = texture->texture_reference;
 	SDL_Rect final_source_region = source_region.to_sdl_rect();
 	SDL_FRect final_destination = final_draw_rect.to_sdl_frect();
 
+	const Vector2f draw_scale = global_transform.scale * transform.scale;
+	const Texture_Mipmap *mipmap = get_texture_mipmap_for_scale(texture, std::max(std::abs(draw_scale.x), std::abs(draw_scale.y)));
+
+	if (mipmap) {
+		const Vector2f mipmap_ratio = Vector2f(mipmap->size) / Vector2f(texture->size);
+
+		texture_reference = mipmap->texture_reference;
+		final_source_region.x = static_cast<int>(final_source_region.x * mipmap_ratio.x);
+		final_source_region.y = static_cast<int>(final_source_region.y * mipmap_ratio.y);
+		final_source_region.w = std::max(1, static_cast<int>(std::round(final_source_region.w * mipmap_ratio.x)));
+		final_source_region.h = std::max(1, static_cast<int>(std::round(final_source_region.h * mipmap_ratio.y)));
+	}
+
+	SDL_SetTextureAlphaMod(texture_reference, modulate.a);
+	SDL_SetTextureColorMod(texture_reference, modulate.r, modulate.g, modulate.b);
+	SDL_SetTextureBlendMode(texture_reference, canvas_item->blend_mode);
+	SDL_SetTextureScaleMode(texture_reference, canvas_item->scale_mode);
+
 	if (rotation.is_zero_angle())
-		SDL_RenderCopyF(viewport->get_renderer(), texture->texture_reference, &final_source_region, &final_destination);
+		SDL_RenderCopyF(viewport->get_renderer(), texture_reference, &final_source_region, &final_destination);
 	else
-		SDL_RenderCopyExF(viewport->get_renderer(), texture->texture_reference, &final_source_region, &final_destination, rotation.get_angle_degrees(), nullptr, flip);
+		SDL_RenderCopyExF(viewport->get_renderer(), texture_reference, &final_source_region, &final_destination, rotation.get_angle_degrees(), nullptr, flip);
 }
 
 void detail::RectDrawingItem::_draw(const std::shared_ptr<CanvasItem> &canvas_item, const Viewport *viewport) {
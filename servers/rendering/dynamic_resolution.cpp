@@ -0,0 +1,99 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <servers/rendering/dynamic_resolution.hpp>
+
+#include <algorithm>
+
+using namespace Toof;
+
+DynamicResolution::DynamicResolution(): target_frame_time(1.0 / 60.0),
+    average_frame_time(0.0),
+    smoothing(0.1),
+    hysteresis(0.1),
+    scale(1.0),
+    min_scale(0.5),
+    max_scale(1.0),
+    scale_step(0.05),
+    frames_to_lower(10),
+    frames_to_raise(60),
+    frames_over_budget(0),
+    frames_under_budget(0),
+    enabled(false) {
+}
+
+bool DynamicResolution::push_frame_time(const double frame_time) {
+	if (!enabled)
+		return false;
+
+	average_frame_time = average_frame_time == 0.0 ? frame_time : average_frame_time + (frame_time - average_frame_time) * smoothing;
+
+	if (average_frame_time > target_frame_time * (1.0 + hysteresis)) {
+		frames_over_budget++;
+		frames_under_budget = 0;
+	} else if (average_frame_time < target_frame_time * (1.0 - hysteresis)) {
+		frames_under_budget++;
+		frames_over_budget = 0;
+	} else {
+		frames_over_budget = 0;
+		frames_under_budget = 0;
+	}
+
+	const real previous_scale = scale;
+
+	if (frames_over_budget >= frames_to_lower) {
+		scale = std::max(scale - scale_step, min_scale);
+		frames_over_budget = 0;
+	} else if (frames_under_budget >= frames_to_raise) {
+		scale = std::min(scale + scale_step, max_scale);
+		frames_under_budget = 0;
+	}
+
+	return scale != previous_scale;
+}
+
+void DynamicResolution::reset() {
+	scale = max_scale;
+	average_frame_time = 0.0;
+	frames_over_budget = 0;
+	frames_under_budget = 0;
+}
+
+void DynamicResolution::set_enabled(const bool new_enabled) {
+	enabled = new_enabled;
+	reset();
+}
+
+void DynamicResolution::set_scale_bounds(const real new_min_scale, const real new_max_scale) {
+	min_scale = std::clamp<real>(new_min_scale, 0.1, 1.0);
+	max_scale = std::clamp<real>(new_max_scale, min_scale, 1.0);
+	scale = std::clamp(scale, min_scale, max_scale);
+}
@@ -0,0 +1,183 @@
+/*  This file is part of the Toof Engine. */
+/** @file dynamic_resolution.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <core/math/math_defs.hpp>
+
+namespace Toof {
+
+/**
+* @brief Controls the internal render resolution, lowering it when frames take longer than the target frame time and raising it again when there is headroom.
+* @details The frame time is smoothed with an exponential moving average. The scale is only lowered after the average stayed above
+* the target plus the hysteresis for @b frames_to_lower consecutive frames, and only raised after it stayed below the target minus
+* the hysteresis for @b frames_to_raise consecutive frames, which keeps the resolution from oscillating.
+* @note RenderingServer feeds the time spent rendering a frame, from before the canvas is drawn until it was presented, so idle time
+* between frames isn't counted. With vsync presenting may block until the next refresh, so the target frame time should then be set
+* above the refresh interval for the scale to be raised again, for example 1/50 on a 60Hz display.
+*/
+class DynamicResolution {
+private:
+	double target_frame_time;
+	double average_frame_time;
+	double smoothing;
+	double hysteresis;
+	real scale;
+	real min_scale;
+	real max_scale;
+	real scale_step;
+	int frames_to_lower;
+	int frames_to_raise;
+	int frames_over_budget;
+	int frames_under_budget;
+	bool enabled;
+
+public:
+	DynamicResolution();
+
+	/**
+	* @brief Feeds the time the last frame took in seconds, adjusting the scale if needed.
+	* @returns true if the scale changed.
+	*/
+	bool push_frame_time(const double frame_time);
+
+	/**
+	* @brief Resets the scale to the maximum scale and clears the frame time history.
+	*/
+	void reset();
+
+	void set_enabled(const bool new_enabled);
+
+	constexpr bool is_enabled() const {
+		return enabled;
+	}
+
+	/**
+	* @brief Sets the frame time in seconds the controller tries to hold.
+	*/
+	constexpr void set_target_frame_time(const double new_target_frame_time) {
+		target_frame_time = new_target_frame_time;
+	}
+
+	constexpr double get_target_frame_time() const {
+		return target_frame_time;
+	}
+
+	/**
+	* @brief Sets the weight of the newest frame time in the average, between 0 and 1.
+	*/
+	constexpr void set_smoothing(const double new_smoothing) {
+		smoothing = new_smoothing;
+	}
+
+	constexpr double get_smoothing() const {
+		return smoothing;
+	}
+
+	/**
+	* @brief Sets how far, as a fraction of the target frame time, the average frame time has to be from the target before the scale changes.
+	*/
+	constexpr void set_hysteresis(const double new_hysteresis) {
+		hysteresis = new_hysteresis;
+	}
+
+	constexpr double get_hysteresis() const {
+		return hysteresis;
+	}
+
+	/**
+	* @brief Sets the bounds of the scale, relative to the output size of the viewport.
+	*/
+	void set_scale_bounds(const real new_min_scale, const real new_max_scale);
+
+	constexpr real get_min_scale() const {
+		return min_scale;
+	}
+
+	constexpr real get_max_scale() const {
+		return max_scale;
+	}
+
+	/**
+	* @brief Sets how much the scale changes with each adjustment.
+	*/
+	constexpr void set_scale_step(const real new_scale_step) {
+		scale_step = new_scale_step;
+	}
+
+	constexpr real get_scale_step() const {
+		return scale_step;
+	}
+
+	/**
+	* @brief Sets the amount of consecutive frames over and under budget needed before the scale is lowered or raised.
+	*/
+	constexpr void set_adjustment_delay(const int new_frames_to_lower, const int new_frames_to_raise) {
+		frames_to_lower = new_frames_to_lower;
+		frames_to_raise = new_frames_to_raise;
+	}
+
+	constexpr int get_frames_to_lower() const {
+		return frames_to_lower;
+	}
+
+	constexpr int get_frames_to_raise() const {
+		return frames_to_raise;
+	}
+
+	/**
+	* @brief Returns the current scale of the internal resolution, 1 being the output size of the viewport.
+	*/
+	constexpr real get_scale() const {
+		return enabled ? scale : 1.0;
+	}
+
+	constexpr double get_average_frame_time() const {
+		return average_frame_time;
+	}
+
+	/**
+	* @brief Returns the amount of consecutive frames the average frame time has been above the target plus the hysteresis.
+	*/
+	constexpr int get_frames_over_budget() const {
+		return frames_over_budget;
+	}
+
+	/**
+	* @brief Returns the amount of consecutive frames the average frame time has been below the target minus the hysteresis.
+	*/
+	constexpr int get_frames_under_budget() const {
+		return frames_under_budget;
+	}
+};
+
+}
@@ -0,0 +1,83 @@
+/*  This file is part of the Toof Engine. */
+/** @file sub_viewport.hpp */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <servers/rendering_server.hpp>
+#include <servers/rendering/viewport.hpp>
+#include <servers/rendering/texture.hpp>
+#include <core/math/color.hpp>
+
+#include <memory>
+
+namespace Toof {
+
+namespace detail {
+
+/**
+* @brief An offscreen viewport that renders its canvas items into a target texture.
+* @details The texture is registered under the same uid as the sub viewport, so it can be drawn like any other texture.
+*/
+struct SubViewport {
+	Viewport viewport;
+	std::shared_ptr<Texture_Ref> texture;
+	ColorV clear_color = ColorV(0, 0, 0, 0);
+	RenderingServer::SubViewportUpdateMode update_mode = RenderingServer::SUB_VIEWPORT_UPDATE_ALWAYS;
+	natural update_interval = 1;
+	natural frames_since_update = 0;
+	bool dirty = true;
+
+	/**
+	* @brief Advances the frame counter and returns true if the sub viewport should be rendered this frame.
+	*/
+	bool advance_frame() {
+		frames_since_update++;
+
+		switch (update_mode) {
+			case RenderingServer::SUB_VIEWPORT_UPDATE_DISABLED:
+				return false;
+			case RenderingServer::SUB_VIEWPORT_UPDATE_ONCE:
+				update_mode = RenderingServer::SUB_VIEWPORT_UPDATE_DISABLED;
+				return true;
+			case RenderingServer::SUB_VIEWPORT_UPDATE_WHEN_DIRTY:
+				return dirty && frames_since_update >= update_interval;
+			case RenderingServer::SUB_VIEWPORT_UPDATE_ALWAYS:
+				return frames_since_update >= update_interval;
+		}
+
+		return false;
+	}
+};
+
+}
+
+}
@@ -35,15 +35,46 @@
 #include <core/math/vector2.hpp>
 
 #include <SDL_render.h>
+#include <SDL_pixels.h>
+
+#include <vector>
 
 namespace Toof {
 
 namespace detail {
 
+constexpr size_t get_texture_memory_usage(const Vector2i &size, const uint32_t format) {
+	return static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * SDL_BYTESPERPIXEL(format);
+}
+
+/**
+* @brief A downscaled variant of a texture. Every level is half the size of the previous one.
+*/
+struct Texture_Mipmap {
+	SDL_Texture *texture_reference;
+	Vector2i size;
+};
+
 struct Texture_Ref {
 	SDL_Texture *texture_reference;
 	Vector2i size;
 	uint32_t format;
+	SDL_TextureAccess access;
+	bool locked;
+	std::vector<Texture_Mipmap> mipmaps;
+
+	size_t get_memory_usage() const {
+		return get_texture_memory_usage(size, format);
+	}
+
+	size_t get_mipmaps_memory_usage() const {
+		size_t memory_usage = 0;
+
+		for (const Texture_Mipmap &mipmap: mipmaps)
+			memory_usage += get_texture_memory_usage(mipmap.size, format);
+
+		return memory_usage;
+	}
 };
 
 }
@@ -35,7 +35,7 @@
 
 using namespace Toof;
 
-Viewport::Viewport(): vsync(true), window(nullptr), canvas_transform(Transform2D::IDENTITY) {
+Viewport::Viewport(): vsync(true), window(nullptr), renderer(nullptr), render_target(nullptr), canvas_transform(Transform2D::IDENTITY) {
 }
 
 void Viewport::create(Window *from_window) {
@@ -44,10 +44,19 @@ void Viewport::create(Window *from_window) {
 	set_vsync_enabled(vsync);
 }
 
+void Viewport::create(SDL_Renderer *from_renderer, SDL_Texture *target) {
+	renderer = from_renderer;
+	render_target = target;
+}
+
 Vector2i Viewport::get_viewport_size() const {
 	int x;
 	int y;
-	SDL_GetRendererOutputSize(renderer, &x, &y);
+
+	if (render_target)
+		SDL_QueryTexture(render_target, NULL, NULL, &x, &y);
+	else
+		SDL_GetRendererOutputSize(renderer, &x, &y);
 	return Vector2i((integer)x, (integer)y);
 }
 
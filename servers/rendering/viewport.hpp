@@ -50,6 +50,7 @@ private:
 
 	Window *window;
 	SDL_Renderer *renderer;
+	SDL_Texture *render_target;
 
 	Transform2D canvas_transform;
 
@@ -59,6 +60,12 @@ public:
 
 	void create(Window *from_window);
 
+	/**
+	* @brief Makes this Viewport draw into @param target instead of a window, sharing @param from_renderer.
+	* @note @param target must have been created with SDL_TEXTUREACCESS_TARGET. The Viewport does not own the texture.
+	*/
+	void create(SDL_Renderer *from_renderer, SDL_Texture *target);
+
 	Vector2i get_viewport_size() const;
 
 	constexpr Window *get_window() const {
@@ -69,6 +76,13 @@ public:
 		return renderer;
 	}
 
+	/**
+	* @brief Returns the texture this Viewport draws into, or nullptr if it draws into the window.
+	*/
+	constexpr SDL_Texture *get_render_target() const {
+		return render_target;
+	}
+
 	void set_vsync_enabled(const bool vsync_enabled);
 	constexpr bool is_vsync_enabled() const {
 		return vsync;
@@ -33,18 +33,37 @@
 #include <servers/rendering/2d/drawing_item.hpp>
 #include <servers/rendering_server.hpp>
 #include <servers/rendering/viewport.hpp>
+#include <servers/rendering/sub_viewport.hpp>
 #include <servers/rendering/texture.hpp>
+#include <core/os/profiler.hpp>
 
 #include <SDL_image.h>
+#include <SDL_timer.h>
 
 #include <algorithm>
+#include <cstring>
 
 using namespace Toof;
 
 RenderingServer::RenderingServer(Viewport *viewport): viewport(viewport),
     textures(),
     canvas_items(),
+    sub_viewports(),
+    texture_updates(),
+    texture_updates_mutex(),
     background_color(ColorV(77, 77, 77, 255)),
+    canvas_modulate(ColorV::WHITE()),
+    light_buffer(nullptr),
+    light_buffer_size(),
+    light_blend_mode(SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_DST_COLOR, SDL_BLENDFACTOR_ZERO, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD)),
+    light_buffer_scale(LIGHT_BUFFER_SCALE_HALF),
+    dynamic_resolution(),
+    scaled_buffer(nullptr),
+    scaled_buffer_size(),
+    frame_time_skipped(true),
+    redraw_needed(true),
+    drawn_canvas_transform(Transform2D::IDENTITY),
+    drawn_screen_size(),
     uid_index(1) {
 }
 
@@ -54,19 +73,143 @@ RenderingServer::~RenderingServer() {
 
 	textures.clear();
 	canvas_items.clear();
+	sub_viewports.clear();
+
+	if (light_buffer)
+		SDL_DestroyTexture(light_buffer);
+
+	if (scaled_buffer)
+		SDL_DestroyTexture(scaled_buffer);
 }
 
 Vector2i RenderingServer::get_screen_size() const {
 	return viewport->get_viewport_size();
 }
 
+bool RenderingServer::is_redraw_needed() const {
+	return redraw_needed.load(std::memory_order_relaxed) || !(drawn_canvas_transform == viewport->get_canvas_transform()) || drawn_screen_size != get_screen_size();
+}
+
 void RenderingServer::render() {
+	TOOF_PROFILE_ZONE("RenderingServer::render");
 	SDL_Renderer *renderer = viewport->get_renderer();
+	const uint64_t frame_start_counter = SDL_GetPerformanceCounter();
+
+	redraw_needed.store(false, std::memory_order_relaxed);
+	flush_texture_updates();
+
+	const std::vector<std::shared_ptr<detail::CanvasItem>> sorted_canvas_items = get_sorted_canvas_items();
+	const Rect2i screen_rect = Rect2i(Vector2i(), get_screen_size());
+	drawn_canvas_transform = viewport->get_canvas_transform();
+	drawn_screen_size = screen_rect.get_size();
+	render_sub_viewports(sorted_canvas_items);
+
+	const bool scaled = update_scaled_buffer(screen_rect.get_size());
+	set_frame_render_target(scaled);
 
-	SDL_RenderClear(renderer);
-	render_canvas_items();
 	SDL_SetRenderDrawColor(renderer, background_color.r, background_color.g, background_color.b, background_color.a);
+	SDL_RenderClear(renderer);
+	render_canvas_items(sorted_canvas_items, viewport, 0, screen_rect);
+	render_light_buffer(sorted_canvas_items, screen_rect, scaled);
+
+	if (scaled) {
+		const real scale = dynamic_resolution.get_scale();
+		const SDL_Rect source = Rect2i(0, 0, std::max<integer>(screen_rect.w * scale, 1), std::max<integer>(screen_rect.h * scale, 1)).to_sdl_rect();
+
+		SDL_SetRenderTarget(renderer, NULL);
+		SDL_RenderCopy(renderer, scaled_buffer, &source, NULL);
+	}
+
 	SDL_RenderPresent(renderer);
+	update_frame_time(frame_start_counter);
+}
+
+void RenderingServer::update_frame_time(const uint64_t frame_start_counter) {
+	// The first frame after an idle wait pays for waking up, so it would lower the scale without the frame being slow.
+	if (frame_time_skipped) {
+		frame_time_skipped = false;
+		return;
+	}
+
+	const uint64_t frame_end_counter = SDL_GetPerformanceCounter();
+	dynamic_resolution.push_frame_time(static_cast<double>(frame_end_counter - frame_start_counter) / static_cast<double>(SDL_GetPerformanceFrequency()));
+}
+
+bool RenderingServer::update_scaled_buffer(const Vector2i &screen_size) {
+	if (dynamic_resolution.get_scale() >= 1.0 || screen_size.x <= 0 || screen_size.y <= 0)
+		return false;
+
+	// The buffer is kept at the output size and only its top left part is used, so changing the scale never reallocates it.
+	if (scaled_buffer && scaled_buffer_size == screen_size)
+		return true;
+
+	if (scaled_buffer)
+		SDL_DestroyTexture(scaled_buffer);
+
+	scaled_buffer = SDL_CreateTexture(viewport->get_renderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, screen_size.x, screen_size.y);
+	scaled_buffer_size = screen_size;
+
+	if (scaled_buffer == NULL)
+		return false;
+
+	SDL_SetTextureBlendMode(scaled_buffer, SDL_BLENDMODE_NONE);
+	SDL_SetTextureScaleMode(scaled_buffer, SDL_ScaleModeLinear);
+	return true;
+}
+
+void RenderingServer::set_frame_render_target(const bool scaled) {
+	SDL_Renderer *renderer = viewport->get_renderer();
+
+	if (!scaled) {
+		SDL_SetRenderTarget(renderer, NULL);
+		return;
+	}
+
+	const float scale = dynamic_resolution.get_scale();
+	SDL_SetRenderTarget(renderer, scaled_buffer);
+	SDL_RenderSetScale(renderer, scale, scale);
+}
+
+void RenderingServer::flush_texture_updates() {
+	std::vector<TextureUpdate> pending_updates;
+	{
+		std::lock_guard<std::mutex> lock(texture_updates_mutex);
+		pending_updates.swap(texture_updates);
+	}
+
+	for (const TextureUpdate &texture_update: pending_updates) {
+		Optional<TextureLock> texture_lock = this->texture_lock(texture_update.texture_uid, texture_update.region);
+		if (!texture_lock)
+			continue;
+
+		const std::shared_ptr<detail::Texture_Ref> &texture = get_texture_from_uid(texture_update.texture_uid);
+		const size_t bytes_per_pixel = SDL_BYTESPERPIXEL(texture->format);
+		const size_t pitch = static_cast<size_t>(texture_update.pitch);
+
+		// The locked region is clipped to the texture, the staged pixels that fell outside of it are skipped.
+		const size_t skipped_rows = static_cast<size_t>(texture_lock->region.y - texture_update.region.y);
+		const size_t skipped_bytes = static_cast<size_t>(texture_lock->region.x - texture_update.region.x) * bytes_per_pixel;
+		const size_t row_size = static_cast<size_t>(texture_lock->region.w) * bytes_per_pixel;
+		const size_t copy_size = skipped_bytes < pitch ? std::min(row_size, pitch - skipped_bytes) : 0;
+
+		uint8_t *destination = static_cast<uint8_t*>(texture_lock->pixels);
+
+		for (integer row = 0; copy_size && row < texture_lock->region.h; row++) {
+			const size_t source_offset = (skipped_rows + row) * pitch + skipped_bytes;
+			if (source_offset + copy_size > texture_update.pixels.size())
+				break;
+
+			std::memcpy(destination + row * texture_lock->pitch, texture_update.pixels.data() + source_offset, copy_size);
+		}
+
+		texture_unlock(texture_update.texture_uid);
+	}
+
+	// Give the buffer back so that steady-state updates don't reallocate the queue.
+	pending_updates.clear();
+	std::lock_guard<std::mutex> lock(texture_updates_mutex);
+	if (texture_updates.empty())
+		texture_updates.swap(pending_updates);
 }
 
 const std::shared_ptr<Toof::detail::Texture_Ref> &RenderingServer::get_texture_from_uid(const uid texture_uid) const {
@@ -87,11 +230,24 @@ const std::shared_ptr<Toof::detail::CanvasItem> &RenderingServer::get_canvas_ite
 	return *t;
 }
 
+const std::shared_ptr<Toof::detail::SubViewport> &RenderingServer::get_sub_viewport_from_uid(const uid sub_viewport_uid) const {
+	const auto &iterator = sub_viewports.find(sub_viewport_uid);
+	if (iterator != sub_viewports.end())
+		return iterator->second;
+
+	const std::shared_ptr<detail::SubViewport> _t, *t = &_t;
+	return *t;
+}
+
 void RenderingServer::remove_uid(const uid destroying_uid) {
 	destroy_uid(destroying_uid);
 }
 
 void RenderingServer::destroy_texture(std::shared_ptr<detail::Texture_Ref> &texture) {
+	for (const detail::Texture_Mipmap &mipmap: texture->mipmaps)
+		SDL_DestroyTexture(mipmap.texture_reference);
+
+	texture->mipmaps.clear();
 	SDL_DestroyTexture(texture->texture_reference);
 }
 
@@ -101,30 +257,40 @@ void RenderingServer::destroy_texture_uid(const uid texture_uid) {
 	if (iterator != textures.end()) {
 		destroy_texture(iterator->second);
 		textures.erase(iterator);
+		request_redraw();
 	}
 }
 
 void RenderingServer::destroy_canvas_item_uid(const uid canvas_item_uid) {
-	canvas_items.erase(canvas_item_uid);
+	const auto &iterator = canvas_items.find(canvas_item_uid);
+
+	if (iterator != canvas_items.end()) {
+		canvas_item_changed(iterator->second);
+		canvas_items.erase(iterator);
+	}
+}
+
+void RenderingServer::destroy_sub_viewport_uid(const uid sub_viewport_uid) {
+	sub_viewports.erase(sub_viewport_uid);
 }
 
 void RenderingServer::destroy_uid(const uid destroying_uid) {
 	destroy_canvas_item_uid(destroying_uid);
+	destroy_sub_viewport_uid(destroying_uid);
 	destroy_texture_uid(destroying_uid);
 }
 
-void RenderingServer::render_canvas_item(const std::shared_ptr<detail::CanvasItem> &canvas_item) {
+void RenderingServer::render_canvas_item(const std::shared_ptr<detail::CanvasItem> &canvas_item, const Viewport *target_viewport, const Rect2i &screen_rect) {
 	if (!canvas_item->is_globally_visible() || canvas_item->drawing_items.empty())
 		return;
 
-	const Rect2i screen_rect = Rect2i(Vector2i(), get_screen_size());
-	const Transform2D canvas_transform = viewport->get_canvas_transform();
+	const Transform2D canvas_transform = target_viewport->get_canvas_transform();
 
 	for (const auto &drawing_item: canvas_item->drawing_items) {
 		bool inside_viewport = screen_rect.intersects(rect2f_add_transform(drawing_item->get_draw_rect(canvas_item), canvas_transform));
 
 		if (inside_viewport)
-			drawing_item->draw(canvas_item, viewport);
+			drawing_item->draw(canvas_item, target_viewport);
 	}
 }
 
@@ -132,15 +298,124 @@ bool comparison_function(const std::shared_ptr<Toof::detail::CanvasItem> &left,
 	return left->get_global_zindex() < right->get_global_zindex();
 }
 
-void RenderingServer::render_canvas_items() {
+std::vector<std::shared_ptr<Toof::detail::CanvasItem>> RenderingServer::get_sorted_canvas_items() const {
 	std::vector<std::shared_ptr<detail::CanvasItem>> sorted_canvas_items;
 
-	for (const auto &iterator: canvas_items)
+	sorted_canvas_items.reserve(canvas_items.size());
+	for (const auto &iterator: canvas_items) {
+		iterator.second->set_global_sub_viewport();
 		sorted_canvas_items.push_back(iterator.second);
+	}
 	std::sort(sorted_canvas_items.begin(), sorted_canvas_items.end(), &comparison_function);
 
-	for (const auto &canvas_item: sorted_canvas_items)
-		render_canvas_item(canvas_item);
+	return sorted_canvas_items;
+}
+
+void RenderingServer::render_canvas_items(const std::vector<std::shared_ptr<detail::CanvasItem>> &sorted_canvas_items, const Viewport *target_viewport, const uid sub_viewport_uid, const Rect2i &screen_rect) {
+	for (const auto &canvas_item: sorted_canvas_items) {
+		if (!canvas_item->light && canvas_item->global_sub_viewport == sub_viewport_uid)
+			render_canvas_item(canvas_item, target_viewport, screen_rect);
+	}
+}
+
+bool RenderingServer::update_light_buffer(const Vector2i &screen_size) {
+	const Vector2i size = Vector2i((screen_size.x + light_buffer_scale - 1) / light_buffer_scale, (screen_size.y + light_buffer_scale - 1) / light_buffer_scale);
+
+	if (light_buffer && light_buffer_size == size)
+		return true;
+
+	if (light_buffer)
+		SDL_DestroyTexture(light_buffer);
+
+	light_buffer = SDL_CreateTexture(viewport->get_renderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+	light_buffer_size = size;
+
+	if (light_buffer == NULL)
+		return false;
+
+	SDL_SetTextureBlendMode(light_buffer, light_blend_mode);
+	SDL_SetTextureScaleMode(light_buffer, SDL_ScaleModeLinear);
+	return true;
+}
+
+void RenderingServer::render_light_buffer(const std::vector<std::shared_ptr<detail::CanvasItem>> &sorted_canvas_items, const Rect2i &screen_rect, const bool scaled) {
+	std::vector<std::shared_ptr<detail::CanvasItem>> lights;
+
+	for (const auto &canvas_item: sorted_canvas_items) {
+		if (canvas_item->light && !canvas_item->global_sub_viewport)
+			lights.push_back(canvas_item);
+	}
+
+	if (lights.empty() && canvas_modulate == ColorV::WHITE())
+		return;
+
+	// Culling happens in screen space, the render scale shrinks the lights into the buffer.
+	SDL_Renderer *renderer = viewport->get_renderer();
+	const SDL_Rect destination = screen_rect.to_sdl_rect();
+
+	if (!update_light_buffer(screen_rect.get_size()))
+		return;
+
+	SDL_SetRenderTarget(renderer, light_buffer);
+	SDL_RenderSetScale(renderer, 1.0f / light_buffer_scale, 1.0f / light_buffer_scale);
+	SDL_SetRenderDrawColor(renderer, canvas_modulate.r, canvas_modulate.g, canvas_modulate.b, 255);
+	SDL_RenderClear(renderer);
+
+	for (const auto &light: lights)
+		render_canvas_item(light, viewport, screen_rect);
+
+	set_frame_render_target(scaled);
+	SDL_RenderCopy(renderer, light_buffer, NULL, &destination);
+}
+
+void RenderingServer::set_light_buffer_scale(const LightBufferScale scale) {
+	light_buffer_scale = scale;
+	request_redraw();
+}
+
+void RenderingServer::render_sub_viewports(const std::vector<std::shared_ptr<detail::CanvasItem>> &sorted_canvas_items) {
+	if (sub_viewports.empty())
+		return;
+
+	SDL_Renderer *renderer = viewport->get_renderer();
+	bool render_target_changed = false;
+
+	for (const auto &iterator: sub_viewports) {
+		const std::shared_ptr<detail::SubViewport> &sub_viewport = iterator.second;
+
+		if (!sub_viewport->advance_frame()) {
+			// Keep rendering frames until the sub viewport catches up with its changes.
+			if (sub_viewport->dirty && sub_viewport->update_mode != SUB_VIEWPORT_UPDATE_DISABLED)
+				request_redraw();
+			continue;
+		}
+
+		const ColorV &clear_color = sub_viewport->clear_color;
+
+		SDL_SetRenderTarget(renderer, sub_viewport->texture->texture_reference);
+		SDL_SetRenderDrawColor(renderer, clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+		SDL_RenderClear(renderer);
+		render_canvas_items(sorted_canvas_items, &sub_viewport->viewport, iterator.first, Rect2i(Vector2i(), sub_viewport->texture->size));
+
+		sub_viewport->dirty = false;
+		sub_viewport->frames_since_update = 0;
+		render_target_changed = true;
+	}
+
+	if (render_target_changed)
+		SDL_SetRenderTarget(renderer, NULL);
+}
+
+void RenderingServer::canvas_item_changed(const std::shared_ptr<detail::CanvasItem> &canvas_item) {
+	request_redraw();
+
+	const uid sub_viewport_uid = canvas_item->get_sub_viewport();
+	if (!sub_viewport_uid)
+		return;
+
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+	if (sub_viewport)
+		sub_viewport->dirty = true;
 }
 
 Optional<RenderingServer::TextureInfo> RenderingServer::get_texture_info_from_uid(const uid texture_uid) const {
@@ -153,14 +428,102 @@ Optional<RenderingServer::TextureInfo> RenderingServer::get_texture_info_from_ui
 	texture_info.size = texture->size;
 	texture_info.format = texture->format;
 	texture_info.texture = texture->texture_reference;
+	texture_info.mipmap_count = texture->mipmaps.size();
+	texture_info.memory_usage = texture->get_memory_usage() + texture->get_mipmaps_memory_usage();
 	return texture_info;
 }
 
-Optional<uid> RenderingServer::load_texture_from_path(const String &path) {
-	SDL_Texture *texture = IMG_LoadTexture(viewport->get_renderer(), path.c_str());
-	if (texture == NULL)
+RenderingServer::TextureStats RenderingServer::get_texture_stats() const {
+	TextureStats texture_stats = {0, 0, 0, 0};
+
+	for (const auto &iterator: textures) {
+		texture_stats.texture_count++;
+		texture_stats.mipmap_count += iterator.second->mipmaps.size();
+		texture_stats.texture_memory += iterator.second->get_memory_usage();
+		texture_stats.mipmap_memory += iterator.second->get_mipmaps_memory_usage();
+	}
+
+	return texture_stats;
+}
+
+static SDL_Surface *downscale_surface(SDL_Surface *surface) {
+	const int width = std::max(surface->w / 2, 1);
+	const int height = std::max(surface->h / 2, 1);
+
+	SDL_Surface *downscaled_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, surface->format->format);
+	if (downscaled_surface == NULL)
+		return NULL;
+
+	SDL_LockSurface(surface);
+	SDL_LockSurface(downscaled_surface);
+
+	// Average every 2x2 block of the source, the last row and column are clamped for odd sizes.
+	for (int y = 0; y < height; y++) {
+		const int source_y = std::min(y * 2, surface->h - 1);
+		const int next_source_y = std::min(source_y + 1, surface->h - 1);
+
+		const uint8_t *row = static_cast<const uint8_t*>(surface->pixels) + source_y * surface->pitch;
+		const uint8_t *next_row = static_cast<const uint8_t*>(surface->pixels) + next_source_y * surface->pitch;
+		uint8_t *destination_row = static_cast<uint8_t*>(downscaled_surface->pixels) + y * downscaled_surface->pitch;
+
+		for (int x = 0; x < width; x++) {
+			const int source_x = std::min(x * 2, surface->w - 1) * 4;
+			const int next_source_x = std::min(x * 2 + 1, surface->w - 1) * 4;
+
+			for (int channel = 0; channel < 4; channel++) {
+				const int sum = row[source_x + channel] + row[next_source_x + channel] + next_row[source_x + channel] + next_row[next_source_x + channel];
+				destination_row[x * 4 + channel] = static_cast<uint8_t>((sum + 2) / 4);
+			}
+		}
+	}
+
+	SDL_UnlockSurface(downscaled_surface);
+	SDL_UnlockSurface(surface);
+
+	return downscaled_surface;
+}
+
+void RenderingServer::generate_texture_mipmaps(const std::shared_ptr<detail::Texture_Ref> &texture, SDL_Surface *surface) {
+	SDL_Surface *previous_surface = surface;
+
+	while (previous_surface->w > 1 || previous_surface->h > 1) {
+		SDL_Surface *mipmap_surface = downscale_surface(previous_surface);
+		if (previous_surface != surface)
+			SDL_FreeSurface(previous_surface);
+
+		if (mipmap_surface == NULL)
+			return;
+
+		SDL_Texture *mipmap_texture = SDL_CreateTextureFromSurface(viewport->get_renderer(), mipmap_surface);
+		if (mipmap_texture == NULL) {
+			SDL_FreeSurface(mipmap_surface);
+			return;
+		}
+
+		texture->mipmaps.push_back({mipmap_texture, Vector2i(mipmap_surface->w, mipmap_surface->h)});
+		previous_surface = mipmap_surface;
+	}
+
+	if (previous_surface != surface)
+		SDL_FreeSurface(previous_surface);
+}
+
+Optional<uid> RenderingServer::load_texture_from_path(const String &path, const bool generate_mipmaps) {
+	SDL_Surface *loaded_surface = IMG_Load(path.c_str());
+	if (loaded_surface == NULL)
 		return NullOption;
 
+	SDL_Surface *surface = SDL_ConvertSurfaceFormat(loaded_surface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(loaded_surface);
+	if (surface == NULL)
+		return NullOption;
+
+	SDL_Texture *texture = SDL_CreateTextureFromSurface(viewport->get_renderer(), surface);
+	if (texture == NULL) {
+		SDL_FreeSurface(surface);
+		return NullOption;
+	}
+
 	uid new_uid = assign_uid();
 	auto new_texture = std::make_shared<detail::Texture_Ref>();
 	new_texture->texture_reference = texture;
@@ -170,11 +533,82 @@ Optional<uid> RenderingServer::load_texture_from_path(const String &path) {
 	SDL_QueryTexture(texture, &new_texture->format, NULL, &width, &height);
 
 	new_texture->size = Vector2i(width, height);
+	new_texture->access = SDL_TEXTUREACCESS_STATIC;
+	new_texture->locked = false;
+
+	if (generate_mipmaps)
+		generate_texture_mipmaps(new_texture, surface);
+
+	SDL_FreeSurface(surface);
 	textures.insert({new_uid, new_texture});
 
 	return new_uid;
 }
 
+Optional<uid> RenderingServer::create_texture(const Vector2i &size, const SDL_TextureAccess access, const uint32_t format) {
+	if (size.x <= 0 || size.y <= 0)
+		return NullOption;
+
+	SDL_Texture *texture = SDL_CreateTexture(viewport->get_renderer(), format, access, size.x, size.y);
+	if (texture == NULL)
+		return NullOption;
+
+	uid new_uid = assign_uid();
+	auto new_texture = std::make_shared<detail::Texture_Ref>();
+
+	new_texture->texture_reference = texture;
+	new_texture->size = size;
+	new_texture->format = format;
+	new_texture->access = access;
+	new_texture->locked = false;
+
+	textures.insert({new_uid, new_texture});
+	return new_uid;
+}
+
+Optional<RenderingServer::TextureLock> RenderingServer::texture_lock(const uid texture_uid, const Rect2i &region) {
+	const std::shared_ptr<detail::Texture_Ref> &texture = get_texture_from_uid(texture_uid);
+
+	if (!texture || texture->locked || texture->access != SDL_TEXTUREACCESS_STREAMING)
+		return NullOption;
+
+	const Rect2i texture_rect = Rect2i(Vector2i(), texture->size);
+	const Rect2i lock_region = region.has_area() ? texture_rect.intersection(region) : texture_rect;
+
+	if (!lock_region.has_area())
+		return NullOption;
+
+	const SDL_Rect sdl_lock_region = lock_region.to_sdl_rect();
+	TextureLock texture_lock;
+	texture_lock.region = lock_region;
+
+	if (SDL_LockTexture(texture->texture_reference, &sdl_lock_region, &texture_lock.pixels, &texture_lock.pitch) != 0)
+		return NullOption;
+
+	texture->locked = true;
+	return texture_lock;
+}
+
+void RenderingServer::texture_unlock(const uid texture_uid) {
+	const std::shared_ptr<detail::Texture_Ref> &texture = get_texture_from_uid(texture_uid);
+
+	if (!texture || !texture->locked)
+		return;
+
+	SDL_UnlockTexture(texture->texture_reference);
+	texture->locked = false;
+	request_redraw();
+}
+
+void RenderingServer::texture_queue_update(const uid texture_uid, const Rect2i &region, std::vector<uint8_t> &&pixels, const int pitch) {
+	if (!region.has_area() || pitch <= 0 || pixels.empty())
+		return;
+
+	std::lock_guard<std::mutex> lock(texture_updates_mutex);
+	texture_updates.push_back({texture_uid, region, std::move(pixels), pitch});
+	request_redraw();
+}
+
 uid RenderingServer::create_canvas_item() {
 	uid new_uid = assign_uid();
 	auto canvas_item = std::make_shared<detail::CanvasItem>();
@@ -183,6 +617,20 @@ uid RenderingServer::create_canvas_item() {
 	return new_uid;
 }
 
+std::vector<uid> RenderingServer::create_canvas_items(const natural count) {
+	std::vector<uid> new_uids;
+	new_uids.reserve(count);
+	canvas_items.reserve(canvas_items.size() + count);
+
+	for (natural i = 0; i < count; i++) {
+		const uid new_uid = assign_uid();
+		canvas_items.insert({new_uid, std::make_shared<detail::CanvasItem>()});
+		new_uids.push_back(new_uid);
+	}
+
+	return new_uids;
+}
+
 void RenderingServer::canvas_item_add_texture(const uid texture_uid, const uid canvas_item_uid, const SDL_RendererFlip flip, const ColorV &modulate, const Transform2D &transform) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 	const std::shared_ptr<detail::Texture_Ref> &texture = get_texture_from_uid(texture_uid);
@@ -199,6 +647,7 @@ void RenderingServer::canvas_item_add_texture(const uid texture_uid, const uid c
 	texture_drawing_item->use_region = false;
 
 	canvas_item->drawing_items.push_back(std::move(texture_drawing_item));
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_add_texture_region(const uid texture_uid, const uid canvas_item_uid ,const Rect2i &src_region, const SDL_RendererFlip flip, const ColorV &modulate, const Transform2D &transform) {
@@ -218,6 +667,7 @@ void RenderingServer::canvas_item_add_texture_region(const uid texture_uid, cons
 	texture_rect_drawing_item->use_region = true;
 
 	canvas_item->drawing_items.push_back(std::move(texture_rect_drawing_item));
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_add_line(const uid canvas_item_uid, const Vector2f &start, const Vector2f &end, const ColorV &modulate) {
@@ -233,6 +683,7 @@ void RenderingServer::canvas_item_add_line(const uid canvas_item_uid, const Vect
 	line_drawing_item->modulate = modulate;
 
 	canvas_item->drawing_items.push_back(std::move(line_drawing_item));
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_add_lines(const uid canvas_item_uid, const std::vector<SDL_FPoint> &points, const ColorV &modulate) {
@@ -247,6 +698,7 @@ void RenderingServer::canvas_item_add_lines(const uid canvas_item_uid, const std
 	lines_drawing_item->modulate = modulate;
 
 	canvas_item->drawing_items.push_back(std::move(lines_drawing_item));
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_add_rect(const uid canvas_item_uid, const Rect2f &rect, const ColorV &modulate) {
@@ -261,6 +713,7 @@ void RenderingServer::canvas_item_add_rect(const uid canvas_item_uid, const Rect
 	rect_drawing_item->modulate = modulate;
 
 	canvas_item->drawing_items.push_back(std::move(rect_drawing_item));
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_add_rects(const uid canvas_item_uid, const std::vector<SDL_FRect> &rectangles, const ColorV &modulate) {
@@ -275,13 +728,16 @@ void RenderingServer::canvas_item_add_rects(const uid canvas_item_uid, const std
 	rects_drawing_item->modulate = modulate;
 
 	canvas_item->drawing_items.push_back(std::move(rects_drawing_item));
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_set_transform(const uid canvas_item_uid, const Transform2D &new_transform) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->transform = new_transform;
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_set_parent(const uid canvas_item_uid, const uid parent_item_uid) {
@@ -291,59 +747,191 @@ void RenderingServer::canvas_item_set_parent(const uid canvas_item_uid, const ui
 	if (!canvas_item)
 		return;
 
+	canvas_item_changed(canvas_item);
+
 	if (parent_canvas_item)
 		canvas_item->parent = parent_canvas_item;
 	else
 		canvas_item->parent = std::weak_ptr<detail::CanvasItem>();
+
+	canvas_item_changed(canvas_item);
 }
 
 void RenderingServer::canvas_item_set_modulate(const uid canvas_item_uid, const ColorV &new_modulate) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->modulate = new_modulate;
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_set_blend_mode(const uid canvas_item_uid, const SDL_BlendMode blend_mode) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->blend_mode = blend_mode;
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_set_scale_mode(const uid canvas_item_uid, const SDL_ScaleMode scale_mode) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->scale_mode = scale_mode;
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_clear(const uid canvas_item_uid) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->drawing_items.clear();
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_set_visible(const uid canvas_item_uid, const bool visible) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->visible = visible;
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_set_zindex(const uid canvas_item_uid, const int zindex) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->zindex = zindex;
+		canvas_item_changed(canvas_item);
+	}
 }
 
 void RenderingServer::canvas_item_set_zindex_relative(const uid canvas_item_uid, const bool zindex_relative) {
 	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
 
-	if (canvas_item)
+	if (canvas_item) {
 		canvas_item->zindex_relative = zindex_relative;
+		canvas_item_changed(canvas_item);
+	}
+}
+
+void RenderingServer::canvas_item_set_sub_viewport(const uid canvas_item_uid, const uid sub_viewport_uid) {
+	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
+
+	if (!canvas_item)
+		return;
+
+	canvas_item_changed(canvas_item);
+	canvas_item->sub_viewport = sub_viewport_uid;
+	canvas_item_changed(canvas_item);
+}
+
+void RenderingServer::canvas_item_set_light(const uid canvas_item_uid, const bool light) {
+	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
+
+	if (canvas_item) {
+		canvas_item->light = light;
+		canvas_item_changed(canvas_item);
+	}
+}
+
+Optional<uid> RenderingServer::create_sub_viewport(const Vector2i &size) {
+	if (size.x <= 0 || size.y <= 0)
+		return NullOption;
+
+	SDL_Texture *texture = SDL_CreateTexture(viewport->get_renderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+	if (texture == NULL)
+		return NullOption;
+
+	uid new_uid = assign_uid();
+	auto new_texture = std::make_shared<detail::Texture_Ref>();
+	auto sub_viewport = std::make_shared<detail::SubViewport>();
+
+	new_texture->texture_reference = texture;
+	new_texture->size = size;
+	new_texture->format = SDL_PIXELFORMAT_RGBA8888;
+	new_texture->access = SDL_TEXTUREACCESS_TARGET;
+	new_texture->locked = false;
+
+	sub_viewport->texture = new_texture;
+	sub_viewport->viewport.create(viewport->get_renderer(), texture);
+
+	textures.insert({new_uid, new_texture});
+	sub_viewports.insert({new_uid, sub_viewport});
+	return new_uid;
+}
+
+void RenderingServer::sub_viewport_set_size(const uid sub_viewport_uid, const Vector2i &size) {
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+
+	if (!sub_viewport || size.x <= 0 || size.y <= 0 || sub_viewport->texture->size == size)
+		return;
+
+	SDL_Texture *texture = SDL_CreateTexture(viewport->get_renderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+	if (texture == NULL)
+		return;
+
+	// Swap the texture in place so drawing items referencing the Texture_Ref stay valid.
+	SDL_DestroyTexture(sub_viewport->texture->texture_reference);
+	sub_viewport->texture->texture_reference = texture;
+	sub_viewport->texture->size = size;
+	sub_viewport->viewport.create(viewport->get_renderer(), texture);
+	sub_viewport->dirty = true;
+	request_redraw();
+}
+
+void RenderingServer::sub_viewport_set_canvas_transform(const uid sub_viewport_uid, const Transform2D &canvas_transform) {
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+
+	if (sub_viewport) {
+		sub_viewport->viewport.set_canvas_transform(canvas_transform);
+		sub_viewport->dirty = true;
+		request_redraw();
+	}
+}
+
+void RenderingServer::sub_viewport_set_clear_color(const uid sub_viewport_uid, const ColorV &clear_color) {
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+
+	if (sub_viewport) {
+		sub_viewport->clear_color = clear_color;
+		sub_viewport->dirty = true;
+		request_redraw();
+	}
+}
+
+void RenderingServer::sub_viewport_set_update_mode(const uid sub_viewport_uid, const SubViewportUpdateMode update_mode) {
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+
+	if (sub_viewport) {
+		sub_viewport->update_mode = update_mode;
+		request_redraw();
+	}
+}
+
+void RenderingServer::sub_viewport_set_update_interval(const uid sub_viewport_uid, const natural update_interval) {
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+
+	if (sub_viewport)
+		sub_viewport->update_interval = std::max(update_interval, static_cast<natural>(1));
+}
+
+void RenderingServer::sub_viewport_queue_update(const uid sub_viewport_uid) {
+	const std::shared_ptr<detail::SubViewport> &sub_viewport = get_sub_viewport_from_uid(sub_viewport_uid);
+
+	if (sub_viewport) {
+		sub_viewport->dirty = true;
+		request_redraw();
+	}
+}
+
+bool RenderingServer::sub_viewport_uid_exists(const uid sub_viewport_uid) const {
+	return sub_viewports.find(sub_viewport_uid) != sub_viewports.end();
 }
 
 bool RenderingServer::canvas_item_uid_exists(const uid canvas_item_uid) const {
@@ -465,4 +1053,12 @@ Optional<bool> RenderingServer::canvas_item_is_zindex_relative(const uid canvas_
 	if (canvas_item)
 		return canvas_item->zindex_relative;
 	return NullOption;
-}
\ No newline at end of file
+}
+
+Optional<bool> RenderingServer::canvas_item_is_light(const uid canvas_item_uid) const {
+	const std::shared_ptr<detail::CanvasItem> &canvas_item = get_canvas_item_from_uid(canvas_item_uid);
+
+	if (canvas_item)
+		return canvas_item->light;
+	return NullOption;
+}
@@ -36,10 +36,13 @@
 #include <core/math/transform2d.hpp>
 #include <core/math/color.hpp>
 #include <core/memory/optional.hpp>
+#include <servers/rendering/dynamic_resolution.hpp>
 
 #include <SDL_render.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -49,6 +52,7 @@ namespace detail {
 
 struct Texture_Ref;
 struct CanvasItem;
+struct SubViewport;
 
 }
 
@@ -59,10 +63,32 @@ class Viewport;
 
 class RenderingServer {
 private:
+	struct TextureUpdate {
+		uid texture_uid;
+		Rect2i region;
+		std::vector<uint8_t> pixels;
+		int pitch;
+	};
+
 	Viewport *viewport;
 	std::unordered_map<uid, std::shared_ptr<detail::Texture_Ref>> textures;
 	std::unordered_map<uid, std::shared_ptr<detail::CanvasItem>> canvas_items;
+	std::unordered_map<uid, std::shared_ptr<detail::SubViewport>> sub_viewports;
+	std::vector<TextureUpdate> texture_updates;
+	std::mutex texture_updates_mutex;
 	ColorV background_color;
+	ColorV canvas_modulate;
+	SDL_Texture *light_buffer;
+	Vector2i light_buffer_size;
+	SDL_BlendMode light_blend_mode;
+	int light_buffer_scale;
+	DynamicResolution dynamic_resolution;
+	SDL_Texture *scaled_buffer;
+	Vector2i scaled_buffer_size;
+	bool frame_time_skipped;
+	std::atomic<bool> redraw_needed;
+	Transform2D drawn_canvas_transform;
+	Vector2i drawn_screen_size;
 	uid uid_index;
 
 	constexpr uid assign_uid() {
@@ -71,21 +97,96 @@ private:
 		return uid_index++;
 	}
 
-	void render_canvas_item(const std::shared_ptr<detail::CanvasItem> &canvas_item);
-	void render_canvas_items();
+	void render_canvas_item(const std::shared_ptr<detail::CanvasItem> &canvas_item, const Viewport *target_viewport, const Rect2i &screen_rect);
+	void render_light_buffer(const std::vector<std::shared_ptr<detail::CanvasItem>> &sorted_canvas_items, const Rect2i &screen_rect, const bool scaled);
+	bool update_light_buffer(const Vector2i &screen_size);
+	bool update_scaled_buffer(const Vector2i &screen_size);
+	void set_frame_render_target(const bool scaled);
+	void update_frame_time(const uint64_t frame_start_counter);
+	void render_canvas_items(const std::vector<std::shared_ptr<detail::CanvasItem>> &sorted_canvas_items, const Viewport *target_viewport, const uid sub_viewport_uid, const Rect2i &screen_rect);
+	void render_sub_viewports(const std::vector<std::shared_ptr<detail::CanvasItem>> &sorted_canvas_items);
+	std::vector<std::shared_ptr<detail::CanvasItem>> get_sorted_canvas_items() const;
+	void canvas_item_changed(const std::shared_ptr<detail::CanvasItem> &canvas_item);
 	void destroy_texture(std::shared_ptr<detail::Texture_Ref> &texture);
 	void destroy_texture_uid(const uid texture_uid);
 	void destroy_canvas_item_uid(const uid canvas_item_uid);
+	void destroy_sub_viewport_uid(const uid sub_viewport_uid);
 	void destroy_uid(const uid target_uid);
 
+	void flush_texture_updates();
+	void generate_texture_mipmaps(const std::shared_ptr<detail::Texture_Ref> &texture, SDL_Surface *surface);
+
 	const std::shared_ptr<detail::CanvasItem> &get_canvas_item_from_uid(const uid canvas_item_uid) const;
 	const std::shared_ptr<detail::Texture_Ref> &get_texture_from_uid(const uid texture_uid) const;
+	const std::shared_ptr<detail::SubViewport> &get_sub_viewport_from_uid(const uid sub_viewport_uid) const;
 
 public:
+	enum LightBufferScale {
+		/**
+		* @brief Lights are rendered at the full resolution of the viewport.
+		*/
+		LIGHT_BUFFER_SCALE_FULL = 1,
+
+		/**
+		* @brief Lights are rendered at half the width and height of the viewport, a quarter of the pixels.
+		*/
+		LIGHT_BUFFER_SCALE_HALF = 2,
+
+		/**
+		* @brief Lights are rendered at a quarter of the width and height of the viewport, a sixteenth of the pixels.
+		*/
+		LIGHT_BUFFER_SCALE_QUARTER = 4
+	};
+
+	enum SubViewportUpdateMode {
+		/**
+		* @brief The sub viewport is never rendered, the texture keeps its last content.
+		*/
+		SUB_VIEWPORT_UPDATE_DISABLED,
+
+		/**
+		* @brief The sub viewport is rendered on the next frame, then the update mode is set to SUB_VIEWPORT_UPDATE_DISABLED.
+		*/
+		SUB_VIEWPORT_UPDATE_ONCE,
+
+		/**
+		* @brief The sub viewport is rendered only if one of its canvas items changed, at most once every update interval.
+		*/
+		SUB_VIEWPORT_UPDATE_WHEN_DIRTY,
+
+		/**
+		* @brief The sub viewport is rendered once every update interval.
+		*/
+		SUB_VIEWPORT_UPDATE_ALWAYS
+	};
+
 	struct TextureInfo {
 		Vector2i size;
 		uint32_t format;
 		SDL_Texture *texture;
+		size_t mipmap_count;
+		size_t memory_usage;
+	};
+
+	/**
+	* @brief Pixel memory of a locked texture region, written to directly by the CPU.
+	* @details Rows are @b pitch bytes apart, which may be larger than the width of the region times the bytes per pixel.
+	*/
+	struct TextureLock {
+		void *pixels;
+		int pitch;
+		Rect2i region;
+	};
+
+	/**
+	* @brief Memory used by all of the textures loaded by the RenderingServer, in bytes.
+	* @note The sizes are estimated from the texture size and pixel format, the real usage depends on the renderer driver.
+	*/
+	struct TextureStats {
+		size_t texture_count;
+		size_t mipmap_count;
+		size_t texture_memory;
+		size_t mipmap_memory;
 	};
 
 public:
@@ -99,11 +200,41 @@ public:
 		return viewport;
 	}
 
-	Optional<uid> load_texture_from_path(const String &path);
+	/**
+	* @brief Loads the image at @param path as a texture.
+	* If @param generate_mipmaps is true, downscaled variants of the texture are created that are drawn instead when the texture is drawn at half its size or smaller.
+	*/
+	Optional<uid> load_texture_from_path(const String &path, const bool generate_mipmaps = false);
 	uid create_canvas_item();
 
-	constexpr void set_default_background_color(const ColorV &new_background_color) {
+	/**
+	* @brief Creates @param count canvas items at once and returns their uids.
+	*/
+	std::vector<uid> create_canvas_items(const natural count);
+
+	/**
+	* @brief Creates a blank texture of @param size with the pixel @param format.
+	* Textures with SDL_TEXTUREACCESS_STREAMING can be updated every frame with texture_lock/texture_unlock or texture_queue_update.
+	*/
+	Optional<uid> create_texture(const Vector2i &size, const SDL_TextureAccess access = SDL_TEXTUREACCESS_STREAMING, const uint32_t format = SDL_PIXELFORMAT_RGBA32);
+
+	/**
+	* @brief Locks @param region of a streaming texture for write-only access, the returned pixels point straight into the texture memory.
+	* An empty @param region locks the whole texture. Only the locked region is uploaded when the texture is unlocked.
+	* @note The previous content of the locked memory is undefined, every pixel of the region should be written.
+	*/
+	Optional<TextureLock> texture_lock(const uid texture_uid, const Rect2i &region = Rect2i());
+	void texture_unlock(const uid texture_uid);
+
+	/**
+	* @brief Queues @param pixels to be copied into @param region of a streaming texture at the start of the next render.
+	* @details Unlike texture_lock, this can be called from any thread. @param pitch is the length of a row of @param pixels in bytes.
+	*/
+	void texture_queue_update(const uid texture_uid, const Rect2i &region, std::vector<uint8_t> &&pixels, const int pitch);
+
+	inline void set_default_background_color(const ColorV &new_background_color) {
 		background_color = new_background_color;
+		request_redraw();
 	}
 
 	constexpr const ColorV &get_default_background_color() const {
@@ -112,7 +243,65 @@ public:
 
 	Vector2i get_screen_size() const;
 
+	/**
+	* @brief Marks the next frame as different from the last rendered frame. Safe to call from any thread.
+	* @details Modifying a canvas item, texture or sub viewport already requests a redraw.
+	*/
+	inline void request_redraw() {
+		redraw_needed.store(true, std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Returns true if anything changed since the last render, including the canvas transform and the size of the viewport.
+	* @details Used to skip rendering frames identical to the previous one in low processor mode.
+	*/
+	bool is_redraw_needed() const;
+
+	/**
+	* @brief Leaves the time of the next rendered frame out of the dynamic resolution, should be called when rendering was idle.
+	*/
+	constexpr void skip_next_frame_time() {
+		frame_time_skipped = true;
+	}
+
+	/**
+	* @brief Sets the ambient light color the whole canvas is multiplied with, light canvas items brighten it again.
+	* @details Lighting is skipped entirely while this is white and there are no light canvas items.
+	*/
+	inline void set_canvas_modulate(const ColorV &new_canvas_modulate) {
+		canvas_modulate = new_canvas_modulate;
+		request_redraw();
+	}
+
+	constexpr const ColorV &get_canvas_modulate() const {
+		return canvas_modulate;
+	}
+
+	/**
+	* @brief Sets the resolution lights are rendered at, relative to the viewport.
+	* @details Lights are drawn into a reduced resolution buffer and multiplied over the canvas in a single copy,
+	* so their cost scales with the light buffer instead of the screen.
+	*/
+	void set_light_buffer_scale(const LightBufferScale scale);
+
+	constexpr LightBufferScale get_light_buffer_scale() const {
+		return static_cast<LightBufferScale>(light_buffer_scale);
+	}
+
+	/**
+	* @brief Returns the controller of the internal render resolution.
+	* @details When enabled, the canvas is rendered into an offscreen buffer at the scale of the controller and upscaled to the window in a single copy.
+	*/
+	constexpr DynamicResolution &get_dynamic_resolution() {
+		return dynamic_resolution;
+	}
+
+	constexpr const DynamicResolution &get_dynamic_resolution() const {
+		return dynamic_resolution;
+	}
+
 	Optional<TextureInfo> get_texture_info_from_uid(const uid texture_uid) const;
+	TextureStats get_texture_stats() const;
 
 	void canvas_item_add_texture(const uid texture_uid, const uid canvas_item_uid, const SDL_RendererFlip flip = SDL_FLIP_NONE, const ColorV &modulate = ColorV::WHITE(), const Transform2D &transform = Transform2D::IDENTITY);
 	void canvas_item_add_texture_region(const uid texture_uid, const uid canvas_item_uid, const Rect2i &src_region, const SDL_RendererFlip flip = SDL_FLIP_NONE, const ColorV &modulate = ColorV::WHITE(), const Transform2D &transform = Transform2D::IDENTITY);
@@ -132,6 +321,39 @@ public:
 	void canvas_item_set_zindex(const uid canvas_item_uid, const int zindex);
 	void canvas_item_set_zindex_relative(const uid canvas_item_uid, const bool zindex_relative);
 
+	/**
+	* @brief Draws the canvas item and its children into the sub viewport with @param sub_viewport_uid instead of the main viewport.
+	* @details Passing 0 draws the canvas item into the same viewport as its parent.
+	*/
+	void canvas_item_set_sub_viewport(const uid canvas_item_uid, const uid sub_viewport_uid);
+
+	/**
+	* @brief If @param light is true, the canvas item is drawn into the light buffer instead of the canvas.
+	* @note Light canvas items are only supported in the main viewport.
+	*/
+	void canvas_item_set_light(const uid canvas_item_uid, const bool light);
+
+	/**
+	* @brief Creates an offscreen viewport that renders into a texture of @param size.
+	* @details The returned uid is also a texture uid, it can be drawn with canvas_item_add_texture and canvas_item_add_texture_region.
+	*/
+	Optional<uid> create_sub_viewport(const Vector2i &size);
+	void sub_viewport_set_size(const uid sub_viewport_uid, const Vector2i &size);
+	void sub_viewport_set_canvas_transform(const uid sub_viewport_uid, const Transform2D &canvas_transform);
+	void sub_viewport_set_clear_color(const uid sub_viewport_uid, const ColorV &clear_color);
+	void sub_viewport_set_update_mode(const uid sub_viewport_uid, const SubViewportUpdateMode update_mode);
+
+	/**
+	* @brief Renders the sub viewport at most once every @param update_interval frames, for example 4 renders it every 4th frame.
+	*/
+	void sub_viewport_set_update_interval(const uid sub_viewport_uid, const natural update_interval);
+
+	/**
+	* @brief Marks the sub viewport as dirty, rendering it on the next update when using SUB_VIEWPORT_UPDATE_WHEN_DIRTY.
+	*/
+	void sub_viewport_queue_update(const uid sub_viewport_uid);
+	bool sub_viewport_uid_exists(const uid sub_viewport_uid) const;
+
 	bool canvas_item_uid_exists(const uid canvas_item_uid) const;
 	bool texture_uid_exists(const uid canvas_item_uid) const;
 
@@ -151,6 +373,7 @@ public:
 	Optional<int> canvas_item_get_zindex(const uid canvas_item_uid) const;
 	Optional<int> canvas_item_get_absolute_zindex(const uid canvas_item_uid) const;
 	Optional<bool> canvas_item_is_zindex_relative(const uid canvas_item_uid) const;
+	Optional<bool> canvas_item_is_light(const uid canvas_item_uid) const;
 };
 
 }
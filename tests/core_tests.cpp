@@ -0,0 +1,286 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <tests/core_tests.hpp>
+
+#include <core/os/thread_pool.hpp>
+#include <core/memory/call_queue.hpp>
+#include <core/os/profiler.hpp>
+#include <core/math/math_funcs.hpp>
+#include <servers/rendering/dynamic_resolution.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Toof::Tests;
+
+bool ThreadPoolTest::_test() {
+	Toof::ThreadPool thread_pool = Toof::ThreadPool(3);
+	TEST_CASE(thread_pool.get_thread_count() == 3);
+
+	// Every index is called exactly once, and parallel_for only returns once all calls finished.
+	std::vector<std::atomic<int>> calls = std::vector<std::atomic<int>>(1000);
+	for (int round = 0; round < 10; round++) {
+		thread_pool.parallel_for(calls.size(), [&calls](const Toof::natural index) {
+			calls[index]++;
+		});
+
+		for (const std::atomic<int> &call_count: calls)
+			TEST_CASE(call_count == round + 1);
+	}
+
+	bool called = false;
+	thread_pool.parallel_for(0, [&called](const Toof::natural) {
+		called = true;
+	});
+	TEST_CASE(!called);
+
+	// Uneven jobs are spread over the threads through work stealing, so the pool still finishes them all.
+	std::atomic<Toof::natural> total = 0;
+	thread_pool.parallel_for(16, [&total](const Toof::natural index) {
+		Toof::natural sum = 0;
+		for (Toof::natural i = 0; i < (index % 4 == 0 ? 100000 : 10); i++)
+			sum += 1;
+		total += sum;
+	});
+	TEST_CASE(total == 4 * 100000 + 12 * 10);
+
+	return true;
+}
+
+bool CallQueueTest::_test() {
+	Toof::CallQueue call_queue = Toof::CallQueue(4);
+	std::vector<int> calls;
+
+	// Calls that don't fit in the ring buffer, because it is full or the callable is too large, keep their place in the order.
+	const std::array<char, Toof::CallQueue::CALL_STORAGE_SIZE * 2> large_capture = {};
+	for (int i = 0; i < 10; i++) {
+		if (i % 3 == 0)
+			call_queue.push([&calls, i, large_capture]() {
+				calls.push_back(i + large_capture[0]);
+			});
+		else
+			call_queue.push([&calls, i]() {
+				calls.push_back(i);
+			});
+	}
+
+	call_queue.flush();
+	TEST_CASE(calls == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+	// Calls pushed while flushing are made on the next flush.
+	calls.clear();
+	call_queue.push([&calls, &call_queue, large_capture]() {
+		calls.push_back(0);
+		call_queue.push([&calls]() {
+			calls.push_back(2);
+		});
+		call_queue.push([&calls, large_capture]() {
+			calls.push_back(3 + large_capture[0]);
+		});
+	});
+	call_queue.push([&calls]() {
+		calls.push_back(1);
+	});
+
+	call_queue.flush();
+	TEST_CASE(calls == std::vector<int>({0, 1}));
+	call_queue.flush();
+	TEST_CASE(calls == std::vector<int>({0, 1, 2, 3}));
+
+	// Several threads push while the queue is flushed, the calls of each thread are made in the order they were pushed in.
+	constexpr int THREAD_COUNT = 4;
+	constexpr int CALLS_PER_THREAD = 2000;
+	std::array<std::vector<int>, THREAD_COUNT> thread_calls;
+	std::atomic<int> finished_threads = 0;
+	std::vector<std::thread> threads;
+
+	for (int thread_index = 0; thread_index < THREAD_COUNT; thread_index++)
+		threads.emplace_back([&call_queue, &thread_calls, &finished_threads, thread_index, large_capture]() {
+			std::vector<int> &pushed_calls = thread_calls[thread_index];
+
+			for (int i = 0; i < CALLS_PER_THREAD; i++) {
+				if (i % 7 == 0)
+					call_queue.push([&pushed_calls, i, large_capture]() {
+						pushed_calls.push_back(i + large_capture[0]);
+					});
+				else
+					call_queue.push([&pushed_calls, i]() {
+						pushed_calls.push_back(i);
+					});
+			}
+
+			finished_threads++;
+		});
+
+	while (finished_threads < THREAD_COUNT)
+		call_queue.flush();
+
+	for (std::thread &thread: threads)
+		thread.join();
+	call_queue.flush();
+
+	for (const std::vector<int> &pushed_calls: thread_calls) {
+		TEST_CASE(pushed_calls.size() == CALLS_PER_THREAD);
+		for (int i = 0; i < CALLS_PER_THREAD; i++)
+			TEST_CASE(pushed_calls[i] == i);
+	}
+
+	return true;
+}
+
+struct TraceEvent {
+	std::string thread;
+	double start = -1.0;
+	double duration = -1.0;
+};
+
+// Reads the thread, time stamp and duration of the event named @b name from a Chrome trace written by the profiler.
+static TraceEvent find_trace_event(const std::string &trace, const std::string &name) {
+	TraceEvent event;
+	const std::string::size_type position = trace.find("{\"name\":" + name + ",");
+	if (position == std::string::npos)
+		return event;
+
+	const std::string::size_type thread = trace.find("\"tid\":", position) + 6;
+	event.thread = trace.substr(thread, trace.find(',', thread) - thread);
+	event.start = std::stod(trace.substr(trace.find("\"ts\":", position) + 5));
+	event.duration = std::stod(trace.substr(trace.find("\"dur\":", position) + 6));
+	return event;
+}
+
+bool ProfilerTest::_test() {
+	Toof::Profiler &profiler = Toof::Profiler::get_singleton();
+	profiler.clear();
+
+	{
+		const Toof::ProfileZone outer_zone = Toof::ProfileZone("outer");
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		{
+			const Toof::ProfileZone inner_zone = Toof::ProfileZone("inner \"zone\"");
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	std::thread([]() {
+		const Toof::ProfileZone worker_zone = Toof::ProfileZone("worker");
+	}).join();
+
+	std::ostringstream stream;
+	profiler.write_chrome_trace(stream);
+	const std::string trace = stream.str();
+	TEST_CASE(trace.rfind("{\"traceEvents\":[", 0) == 0);
+
+	// Names are escaped, and the inner zone lies within the outer zone on the same thread.
+	const TraceEvent outer = find_trace_event(trace, "\"outer\"");
+	const TraceEvent inner = find_trace_event(trace, "\"inner \\\"zone\\\"\"");
+	const TraceEvent worker = find_trace_event(trace, "\"worker\"");
+	TEST_CASE(outer.duration >= 4000.0 && inner.duration >= 2000.0);
+	TEST_CASE(inner.start >= outer.start && inner.start + inner.duration <= outer.start + outer.duration);
+	TEST_CASE(outer.thread == inner.thread);
+
+	// Every thread records into its own buffer, which is kept after the thread exited.
+	TEST_CASE(worker.duration >= 0.0 && worker.thread != outer.thread);
+
+	// Cleared zones aren't exported anymore.
+	profiler.clear();
+	stream.str("");
+	profiler.write_chrome_trace(stream);
+	TEST_CASE(stream.str() == "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+
+	return true;
+}
+
+bool DynamicResolutionTest::_test() {
+	Toof::DynamicResolution dynamic_resolution;
+	TEST_CASE(!dynamic_resolution.push_frame_time(1.0) && dynamic_resolution.get_scale() == 1.0);
+
+	dynamic_resolution.set_enabled(true);
+	dynamic_resolution.set_target_frame_time(0.01);
+	dynamic_resolution.set_smoothing(0.5);
+	dynamic_resolution.set_hysteresis(0.1);
+	dynamic_resolution.set_scale_step(0.25);
+	dynamic_resolution.set_adjustment_delay(3, 4);
+
+	// The first frame time is taken as is, the next ones move the average by the smoothing.
+	TEST_CASE(!dynamic_resolution.push_frame_time(0.02));
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_average_frame_time(), 0.02));
+	TEST_CASE(!dynamic_resolution.push_frame_time(0.04));
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_average_frame_time(), 0.03));
+	TEST_CASE(dynamic_resolution.get_frames_over_budget() == 2 && dynamic_resolution.get_scale() == 1.0);
+
+	// The scale is lowered on the third frame in a row over the budget, then the count starts over.
+	TEST_CASE(dynamic_resolution.push_frame_time(0.02));
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_average_frame_time(), 0.025));
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_scale(), 0.75) && dynamic_resolution.get_frames_over_budget() == 0);
+
+	// Without smoothing the average is the last frame time.
+	dynamic_resolution.set_smoothing(1.0);
+	TEST_CASE(!dynamic_resolution.push_frame_time(0.02) && !dynamic_resolution.push_frame_time(0.02));
+	TEST_CASE(dynamic_resolution.push_frame_time(0.02) && Toof::Math::is_equal_approx(dynamic_resolution.get_scale(), 0.5));
+
+	// A frame within the hysteresis of the target resets the count.
+	TEST_CASE(!dynamic_resolution.push_frame_time(0.005) && !dynamic_resolution.push_frame_time(0.005) && !dynamic_resolution.push_frame_time(0.005));
+	TEST_CASE(dynamic_resolution.get_frames_under_budget() == 3);
+	TEST_CASE(!dynamic_resolution.push_frame_time(0.0105) && dynamic_resolution.get_frames_under_budget() == 0);
+	TEST_CASE(!dynamic_resolution.push_frame_time(0.005) && !dynamic_resolution.push_frame_time(0.005) && !dynamic_resolution.push_frame_time(0.005));
+	TEST_CASE(dynamic_resolution.push_frame_time(0.005) && Toof::Math::is_equal_approx(dynamic_resolution.get_scale(), 0.75));
+
+	// The scale stays within its bounds, no matter how many frames are over or under the budget.
+	dynamic_resolution.set_scale_bounds(0.6, 0.8);
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_scale(), 0.75));
+
+	for (int i = 0; i < 20; i++) {
+		dynamic_resolution.push_frame_time(0.001);
+		TEST_CASE(dynamic_resolution.get_scale() <= 0.8);
+	}
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_scale(), 0.8));
+
+	for (int i = 0; i < 20; i++) {
+		dynamic_resolution.push_frame_time(1.0);
+		TEST_CASE(dynamic_resolution.get_scale() >= 0.6);
+	}
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_scale(), 0.6));
+
+	dynamic_resolution.set_scale_bounds(0.0, 2.0);
+	TEST_CASE(Toof::Math::is_equal_approx(dynamic_resolution.get_min_scale(), 0.1) && dynamic_resolution.get_max_scale() == 1.0);
+
+	dynamic_resolution.reset();
+	TEST_CASE(dynamic_resolution.get_scale() == 1.0 && dynamic_resolution.get_average_frame_time() == 0.0);
+
+	return true;
+}
@@ -0,0 +1,321 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <tests/input_tests.hpp>
+
+#include <input/input.hpp>
+#include <input/input_map.hpp>
+#include <input/input_event.hpp>
+#include <input/input_recording.hpp>
+#include <scene/main/node.hpp>
+#include <scene/main/scene_tree.hpp>
+
+#include <cstring>
+#include <sstream>
+
+using namespace Toof::Tests;
+
+static std::shared_ptr<Toof::InputEventKeyboard> make_key_event(const SDL_Keycode key_code, const SDL_Scancode scan_code, const uint16_t modifiers = KMOD_NONE) {
+	std::shared_ptr<Toof::InputEventKeyboard> input_event = std::make_shared<Toof::InputEventKeyboard>();
+	input_event->set_keycode(key_code);
+	input_event->set_scan_code(scan_code);
+	input_event->set_modifiers(modifiers);
+	return input_event;
+}
+
+bool InputMapTest::_test() {
+	Toof::InputMap input_map;
+	input_map.create_action("jump");
+	input_map.create_action("attack");
+	input_map.add_key_to_action("jump", make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE));
+	input_map.add_key_to_action("attack", make_key_event(SDLK_a, SDL_SCANCODE_A));
+	input_map.add_key_to_action("attack", make_key_event(SDLK_a, SDL_SCANCODE_A));
+	TEST_CASE(input_map.get_actions().at("attack").inputs.size() == 1);
+
+	std::vector<Toof::String> matched_actions;
+	const auto collect_actions = [&input_map, &matched_actions](const Toof::ActionHandle action_handle) {
+		matched_actions.push_back(input_map.get_action_name(action_handle));
+	};
+
+	// Matching the key code and the scan code still reports the action once.
+	input_map.for_each_event_action(make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE).get(), collect_actions);
+	TEST_CASE(matched_actions == std::vector<Toof::String>({"jump"}));
+
+	// Either the key code or the scan code is enough, the modifiers have to be the same.
+	matched_actions.clear();
+	input_map.for_each_event_action(make_key_event(SDLK_UNKNOWN, SDL_SCANCODE_A).get(), collect_actions);
+	input_map.for_each_event_action(make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE, KMOD_LSHIFT).get(), collect_actions);
+	TEST_CASE(matched_actions == std::vector<Toof::String>({"attack"}));
+
+	matched_actions.clear();
+	input_map.remove_key_from_action("jump", make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE));
+	input_map.clear_action("attack");
+	input_map.for_each_event_action(make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE).get(), collect_actions);
+	input_map.for_each_event_action(make_key_event(SDLK_a, SDL_SCANCODE_A).get(), collect_actions);
+	TEST_CASE(matched_actions.empty());
+	TEST_CASE(input_map.has_action("jump") && !input_map.has_action("attack"));
+
+	// Handles stay the same when an action is cleared and created again.
+	const Toof::ActionHandle attack = input_map.get_action_handle("attack");
+	TEST_CASE(attack.is_valid() && !input_map.has_action(attack));
+	TEST_CASE(input_map.create_action("attack") == attack && input_map.has_action(attack));
+	TEST_CASE(!input_map.get_action_handle("unknown").is_valid());
+
+	return true;
+}
+
+bool InputTest::_test() {
+	Toof::Input input;
+	const Toof::ActionHandle jump = input.get_input_map()->create_action("jump");
+	input.get_input_map()->add_key_to_action("jump", make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE));
+	TEST_CASE(!input.is_anything_pressed() && !input.is_action_pressed(jump));
+
+	SDL_Event event = {};
+	event.type = SDL_KEYDOWN;
+	event.key.type = SDL_KEYDOWN;
+	event.key.keysym.sym = SDLK_SPACE;
+	event.key.keysym.scancode = SDL_SCANCODE_SPACE;
+	const Toof::InputEventRef pressed_event = input.process_event(&event);
+	TEST_CASE(input.is_action_pressed("jump") && input.is_action_pressed(jump) && input.get_action_strength(jump) == 1.0f);
+	TEST_CASE(input.is_key_pressed(SDLK_SPACE) && input.is_physical_key_pressed(SDL_SCANCODE_SPACE) && input.is_anything_pressed());
+
+	event.type = SDL_KEYUP;
+	event.key.type = SDL_KEYUP;
+	input.process_event(&event);
+	TEST_CASE(!input.is_action_pressed(jump) && !input.is_key_pressed(SDLK_SPACE) && !input.is_anything_pressed());
+
+	// Releasing a key that wasn't pressed doesn't mark it as pressed.
+	event.key.keysym.sym = SDLK_d;
+	event.key.keysym.scancode = SDL_SCANCODE_D;
+	input.process_event(&event);
+	TEST_CASE(!input.is_key_pressed(SDLK_d) && !input.is_physical_key_pressed(SDL_SCANCODE_D));
+
+	input.action_press(jump, 0.5f);
+	TEST_CASE(input.is_action_pressed(jump) && input.get_action_strength("jump") == 0.5f);
+	input.action_release("jump");
+	TEST_CASE(!input.is_action_pressed(jump));
+
+	// A cleared action that is created again doesn't keep the state of the old action.
+	input.action_press(jump);
+	input.get_input_map()->clear_action("jump");
+	TEST_CASE(!input.is_action_pressed(jump) && !input.is_anything_pressed());
+	TEST_CASE(input.get_input_map()->create_action("jump") == jump);
+	TEST_CASE(!input.is_action_pressed(jump) && !input.is_action_just_pressed(jump) && input.get_action_strength(jump) == 0.0f);
+	input.get_input_map()->add_key_to_action("jump", make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE));
+
+	// Events live in the arena until they are flushed, retained events are copies that outlive it.
+	TEST_CASE(input.get_event_count() == 3);
+	TEST_CASE(pressed_event.cast_to<Toof::InputEventKeyboard>()->get_keycode() == SDLK_SPACE && pressed_event->is_pressed());
+	const std::shared_ptr<Toof::InputEvent> retained_event = pressed_event.retain();
+	const Toof::InputEvent *pressed_event_address = pressed_event.get();
+
+	input.flush_events();
+	TEST_CASE(input.get_event_count() == 0);
+	event.type = SDL_KEYDOWN;
+	event.key.type = SDL_KEYDOWN;
+	TEST_CASE(input.process_event(&event).get() == pressed_event_address);
+	TEST_CASE(std::static_pointer_cast<Toof::InputEventKeyboard>(retained_event)->get_keycode() == SDLK_SPACE);
+	return true;
+}
+
+class ActionPoller : public Toof::Node {
+	void _process(const double) override {
+		pressed_frames.push_back(get_input()->is_action_pressed(jump));
+	}
+public:
+	Toof::ActionHandle jump;
+	std::vector<bool> pressed_frames;
+};
+
+static void run_recording(Toof::SceneTree &tree, ActionPoller &poller, const std::vector<SDL_Event> &events) {
+	poller.jump = tree.get_input()->get_input_map()->create_action("jump");
+	tree.get_input()->get_input_map()->add_key_to_action("jump", make_key_event(SDLK_SPACE, SDL_SCANCODE_SPACE));
+	poller.set_process(true);
+	tree.get_root()->add_child(&poller);
+
+	// When playing back, no events are passed and the player injects the recorded events instead.
+	for (Toof::natural i = 0; i < 3; i++) {
+		tree.step(2, 1.0 / 60.0);
+		if (i < events.size())
+			tree.get_input()->process_event(&events[i]);
+	}
+
+	tree.get_root()->remove_child(&poller);
+}
+
+bool InputRecordingTest::_test() {
+	SDL_Event event = {};
+	event.type = SDL_KEYDOWN;
+	event.key.type = SDL_KEYDOWN;
+	event.key.timestamp = 100;
+	event.key.keysym.sym = SDLK_SPACE;
+	event.key.keysym.scancode = SDL_SCANCODE_SPACE;
+
+	SDL_Event release_event = event;
+	release_event.type = SDL_KEYUP;
+	release_event.key.type = SDL_KEYUP;
+	release_event.key.timestamp = 200;
+
+	Toof::InputRecorder recorder;
+	Toof::SceneTree recording_tree = Toof::SceneTree(true);
+	ActionPoller recording_poller;
+	recording_tree.get_input()->set_recorder(&recorder);
+	run_recording(recording_tree, recording_poller, {event, release_event});
+	TEST_CASE(recorder.get_event_count() == 2);
+	TEST_CASE(recording_poller.pressed_frames == std::vector<bool>({false, false, true, true, false, false}));
+
+	std::stringstream stream;
+	recorder.write(stream);
+	Toof::InputPlayer player;
+	TEST_CASE(player.read(stream) && !player.is_finished());
+
+	Toof::SceneTree replay_tree = Toof::SceneTree(true);
+	ActionPoller replay_poller;
+	replay_tree.set_input_player(&player);
+	run_recording(replay_tree, replay_poller, {});
+	TEST_CASE(player.is_finished());
+	TEST_CASE(replay_poller.pressed_frames == recording_poller.pressed_frames);
+
+	// The events are restored byte for byte.
+	SDL_Event replayed_event;
+	player.rewind();
+	TEST_CASE(!player.next_event(1, &replayed_event));
+	TEST_CASE(player.next_event(2, &replayed_event) && std::memcmp(&replayed_event.key, &event.key, sizeof(SDL_KeyboardEvent)) == 0);
+
+	TEST_CASE(!player.set_data({1, 2, 3}) && player.is_finished());
+	return true;
+}
+
+class EventCollector : public Toof::Node {
+	void _event(const Toof::InputEventRef event) override {
+		events.push_back(event.retain());
+	}
+public:
+	std::vector<std::shared_ptr<Toof::InputEvent>> events;
+};
+
+// Pushes another event while the merged motion event is being sent, which flushes the coalesced events again.
+class ReentrantEventCollector : public Toof::Node {
+	void _event(const Toof::InputEventRef event) override {
+		events.push_back(event.retain());
+		if (event->get_type() == Toof::EVENT_INPUT_TYPE_MOUSE_MOTION && nested_event) {
+			const SDL_Event *sdl_event = nested_event;
+			nested_event = nullptr;
+			get_tree()->push_sdl_event(sdl_event);
+		}
+	}
+public:
+	std::vector<std::shared_ptr<Toof::InputEvent>> events;
+	const SDL_Event *nested_event = nullptr;
+};
+
+bool InputCoalescingTest::_test() {
+	Toof::SceneTree tree = Toof::SceneTree(true);
+	EventCollector collector;
+	collector.set_process_input(true);
+	tree.get_root()->add_child(&collector);
+
+	const std::shared_ptr<Toof::InputEventMouseButton> left_button = std::make_shared<Toof::InputEventMouseButton>();
+	left_button->set_button(SDL_BUTTON_LEFT);
+	const Toof::ActionHandle shoot = tree.get_input()->get_input_map()->create_action("shoot");
+	tree.get_input()->get_input_map()->add_key_to_action("shoot", left_button);
+
+	SDL_Event motion_event = {};
+	motion_event.type = SDL_MOUSEMOTION;
+	for (int32_t i = 1; i <= 3; i++) {
+		motion_event.motion.x = i * 10;
+		motion_event.motion.xrel = 10;
+		motion_event.motion.yrel = i;
+		tree.push_sdl_event(&motion_event);
+	}
+
+	TEST_CASE(collector.events.empty() && tree.get_input()->get_coalesced_event_count() == 1);
+	TEST_CASE(tree.get_input()->get_mouse_position() == Toof::Vector2f(30, 0));
+
+	// The merged motion is sent before the button event that came after it.
+	SDL_Event button_event = {};
+	button_event.type = SDL_MOUSEBUTTONDOWN;
+	button_event.button.button = SDL_BUTTON_LEFT;
+	button_event.button.x = 30;
+	tree.push_sdl_event(&button_event);
+	TEST_CASE(collector.events.size() == 2);
+	const std::shared_ptr<Toof::InputEventMouseMotion> motion = std::dynamic_pointer_cast<Toof::InputEventMouseMotion>(collector.events[0]);
+	TEST_CASE(motion && motion->get_relative() == Toof::Vector2i32(30, 6) && motion->get_position() == Toof::Vector2i32(30, 0));
+	TEST_CASE(collector.events[1]->get_type() == Toof::EVENT_INPUT_TYPE_MOUSE_BUTTON && collector.events[1]->is_pressed());
+	TEST_CASE(tree.get_input()->is_action_pressed(shoot) && tree.get_input()->is_mouse_button_pressed(SDL_BUTTON_LEFT));
+
+	// Axis events of the same axis keep the latest value, other axes get their own event. They are sent at the start of the process step.
+	collector.events.clear();
+	SDL_Event axis_event = {};
+	axis_event.type = SDL_CONTROLLERAXISMOTION;
+	axis_event.caxis.axis = SDL_CONTROLLER_AXIS_LEFTX;
+	for (const int16_t value: {1000, 20000, -32768}) {
+		axis_event.caxis.value = value;
+		tree.push_sdl_event(&axis_event);
+	}
+
+	axis_event.caxis.axis = SDL_CONTROLLER_AXIS_LEFTY;
+	tree.push_sdl_event(&axis_event);
+	TEST_CASE(collector.events.empty());
+
+	tree.step(1, 1.0 / 60.0);
+	TEST_CASE(collector.events.size() == 2);
+	const std::shared_ptr<Toof::InputEventControllerAxis> axis = std::dynamic_pointer_cast<Toof::InputEventControllerAxis>(collector.events[0]);
+	TEST_CASE(axis && axis->get_axis() == SDL_CONTROLLER_AXIS_LEFTX && axis->get_axis_value() == -1.0f);
+	TEST_CASE(tree.get_input()->get_controller_axis_value(SDL_CONTROLLER_AXIS_LEFTX) == -1.0f);
+
+	collector.events.clear();
+	tree.get_input()->set_coalescing_enabled(false);
+	tree.push_sdl_event(&motion_event);
+	tree.push_sdl_event(&motion_event);
+	TEST_CASE(collector.events.size() == 2);
+	tree.get_root()->remove_child(&collector);
+
+	// An event pushed while flushing doesn't send the merged motion event again.
+	tree.get_input()->set_coalescing_enabled(true);
+	ReentrantEventCollector reentrant_collector;
+	reentrant_collector.set_process_input(true);
+	tree.get_root()->add_child(&reentrant_collector);
+
+	SDL_Event release_event = button_event;
+	release_event.type = SDL_MOUSEBUTTONUP;
+	reentrant_collector.nested_event = &release_event;
+	tree.push_sdl_event(&motion_event);
+	tree.push_sdl_event(&button_event);
+	TEST_CASE(reentrant_collector.events.size() == 3);
+	TEST_CASE(reentrant_collector.events[0]->get_type() == Toof::EVENT_INPUT_TYPE_MOUSE_MOTION);
+	TEST_CASE(reentrant_collector.events[1]->get_type() == Toof::EVENT_INPUT_TYPE_MOUSE_BUTTON && !reentrant_collector.events[1]->is_pressed());
+	TEST_CASE(reentrant_collector.events[2]->get_type() == Toof::EVENT_INPUT_TYPE_MOUSE_BUTTON && reentrant_collector.events[2]->is_pressed());
+	TEST_CASE(tree.get_input()->get_coalesced_event_count() == 0);
+
+	tree.get_root()->remove_child(&reentrant_collector);
+	return true;
+}
\ No newline at end of file
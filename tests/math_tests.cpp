@@ -47,6 +47,7 @@ using Toof::Math::radians_to_degrees;
 using Toof::Math::degrees_to_radians;
 using Toof::Math::is_zero_approx;
 using Toof::Math::is_equal_approx;
+using Toof::Math::lerp_angle_degrees;
 
 constexpr Transform2D add_transform(const Transform2D &left, const Transform2D &right) {
 	Transform2D transform;
@@ -78,5 +79,16 @@ bool MathTest::_test() {
 	TEST_CASE(is_equal_approx(1, 1.0 - CMP_EPSILON));
 	TEST_CASE(is_equal_approx(1, 1.0 + CMP_EPSILON));
 
+	// Angles are interpolated the short way around, also across 0 degrees.
+	TEST_CASE(is_equal_approx(lerp_angle_degrees(359.0, 1.0, 0.5), 360.0));
+	TEST_CASE(is_equal_approx(lerp_angle_degrees(1.0, 359.0, 0.5), 0.0));
+	TEST_CASE(is_equal_approx(lerp_angle_degrees(10.0, 100.0, 0.5), 55.0));
+	TEST_CASE(is_equal_approx(lerp_angle_degrees(-170.0, 170.0, 0.25), -175.0));
+	TEST_CASE(is_equal_approx(lerp_angle_degrees(0.0, 720.0 + 90.0, 1.0), 90.0));
+
+	const Transform2D from = Transform2D(Toof::Angle::from_degrees(350.0), Toof::Vector2f(), Toof::Vector2f(1, 1));
+	const Transform2D to = Transform2D(Toof::Angle::from_degrees(10.0), Toof::Vector2f(), Toof::Vector2f(1, 1));
+	TEST_CASE(is_equal_approx(from.interpolate_with(to, 0.5).rotation.get_angle_degrees(), 360.0));
+
 	return true;
 }
\ No newline at end of file
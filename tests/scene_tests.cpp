@@ -0,0 +1,676 @@
+/*  This file is part of the Toof Engine. */
+/*
+  BSD 3-Clause License
+
+  Copyright (c) 2024-present, Stronkkey and Contributors
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <tests/scene_tests.hpp>
+
+#include <scene/main/node.hpp>
+#include <scene/main/node_pool.hpp>
+#include <scene/main/node_path.hpp>
+#include <scene/main/node_group.hpp>
+#include <scene/main/scene_tree.hpp>
+#include <scene/2d/node2d.hpp>
+#include <scene/2d/sprite2d.hpp>
+#include <scene/resources/file_texture.hpp>
+#include <scene/resources/packed_scene.hpp>
+#include <input/input_event.hpp>
+#include <core/math/math_funcs.hpp>
+
+#include <cereal/archives/portable_binary.hpp>
+
+#include <chrono>
+#include <ratio>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Toof::Tests;
+
+using Node = Toof::Node;
+using NodePool = Toof::NodePool;
+using NodePath = Toof::NodePath;
+
+bool NodeTest::_test() {
+	Node parent;
+	Node first, second, third;
+
+	parent.add_child(&first);
+	parent.add_child(&second);
+	parent.add_child(&third);
+
+	TEST_CASE(parent.get_child_count() == 3);
+	TEST_CASE(parent.get_child(0) == &first && parent.get_child(1) == &second && parent.get_child(2) == &third);
+	TEST_CASE(parent.get_child(3) == nullptr);
+	TEST_CASE(third.get_index() == 2);
+
+	parent.move_child(&third, 0);
+	TEST_CASE(parent.get_child(0) == &third && parent.get_child(1) == &first && parent.get_child(2) == &second);
+	TEST_CASE(third.get_index() == 0 && first.get_index() == 1 && second.get_index() == 2);
+
+	parent.move_child(&third, 10);
+	TEST_CASE(parent.get_child(2) == &third && third.get_index() == 2);
+
+	parent.remove_child(&first);
+	TEST_CASE(parent.get_child_count() == 2);
+	TEST_CASE(parent.get_child(0) == &second && second.get_index() == 0);
+	TEST_CASE(parent.get_child(1) == &third && third.get_index() == 1);
+	TEST_CASE(first.get_parent() == nullptr);
+
+	// Children with the same name are found in turn as the found one is removed or renamed.
+	parent.add_child(&first);
+	second.set_name("Enemy");
+	third.set_name("Enemy");
+	first.set_name("Enemy");
+	TEST_CASE(parent.find_child("Enemy") == &second);
+
+	parent.remove_child(&second);
+	TEST_CASE(parent.find_child("Enemy") == &third);
+
+	third.set_name("Boss");
+	TEST_CASE(parent.find_child("Enemy") == &first && parent.find_child("Boss") == &third);
+
+	parent.remove_child(&first);
+	TEST_CASE(parent.find_child("Enemy") == nullptr && parent.find_child("Boss") == &third);
+	parent.remove_child(&third);
+
+	return true;
+}
+
+bool NodePoolTest::_test() {
+	Node parent;
+	NodePool pool([]() -> Node* {
+		return new Node();
+	});
+
+	pool.reserve(2);
+	TEST_CASE(pool.get_free_count() == 2 && pool.get_created_count() == 2);
+
+	Node *node = pool.acquire(&parent);
+	TEST_CASE(node->get_parent() == &parent && node->get_pool() == &pool && !node->is_in_pool());
+	TEST_CASE(pool.get_free_count() == 1 && pool.get_active_count() == 1 && pool.get_reuse_count() == 1);
+
+	delete node;
+	TEST_CASE(pool.get_active_count() == 0 && parent.get_child_count() == 0);
+
+	// Freeing a pooled node returns it to its pool at the end of the process step, it stays in the tree.
+	SceneTree tree = SceneTree(true);
+	NodePool &tree_pool = tree.get_node_pool<Node>();
+	Node *bullet = tree.acquire_node<Node>(tree.get_root().get());
+	bullet->set_process(true);
+	bullet->add_to_group("Bullets");
+
+	bullet->queue_free();
+	TEST_CASE(bullet->is_queued_for_deletion() && !bullet->is_in_pool());
+
+	tree.step(1, 0.1);
+	TEST_CASE(bullet->is_in_pool() && bullet->is_inside_tree() && !bullet->is_queued_for_deletion());
+	TEST_CASE(tree_pool.get_free_count() == 1 && tree_pool.get_active_count() == 0);
+	TEST_CASE(tree.get_group_node_count("Bullets") == 0);
+
+	Node *reused_bullet = tree.acquire_node<Node>(tree.get_root().get());
+	TEST_CASE(reused_bullet == bullet && !bullet->is_in_pool() && tree_pool.get_reuse_count() == 1);
+	TEST_CASE(tree.get_group_node_count("Bullets") == 1);
+	delete reused_bullet;
+
+	// Nodes taken from a pool outlive it as normal nodes.
+	Node *orphan = nullptr;
+	{
+		NodePool short_pool([]() -> Node* {
+			return new Node();
+		});
+		orphan = short_pool.acquire();
+	}
+	TEST_CASE(orphan->get_pool() == nullptr);
+	delete orphan;
+
+	return true;
+}
+
+bool NodePathTest::_test() {
+	Node root, enemies, enemy, sprite;
+	root.set_name("Root");
+	enemies.set_name("Enemies");
+	enemy.set_name("Enemy");
+	sprite.set_name("Sprite");
+
+	root.add_child(&enemies);
+	enemies.add_child(&enemy);
+	enemy.add_child(&sprite);
+
+	TEST_CASE(root.find_child("Enemies") == &enemies);
+	TEST_CASE(root.find_child("Sprite") == nullptr);
+	TEST_CASE(root.find_child("Sprite", true) == &sprite);
+
+	const NodePath path = "Enemies/Enemy/Sprite";
+	TEST_CASE(path.get_name_count() == 3 && !path.is_absolute());
+	TEST_CASE(root.get_node(path) == &sprite);
+	TEST_CASE(sprite.get_node("../../Enemy") == &enemy);
+	TEST_CASE(sprite.get_node("/Root/Enemies") == &enemies);
+	TEST_CASE(sprite.get_node("/Other/Enemies") == nullptr);
+
+	sprite.set_name("Body");
+	TEST_CASE(root.get_node(path) == nullptr);
+	TEST_CASE(root.get_node("Enemies/Enemy/Body") == &sprite);
+
+	// Changes outside of the path keep its cached result, changes along the path invalidate it.
+	const NodePath body_path = "Enemies/Enemy/Body";
+	TEST_CASE(root.get_node(body_path) == &sprite);
+
+	Node bullet;
+	const uint64_t enemy_version = enemy.get_structure_version();
+	root.add_child(&bullet);
+	TEST_CASE(enemy.get_structure_version() == enemy_version && root.get_node(body_path) == &sprite);
+
+	Node body;
+	body.set_name("Body");
+	enemy.remove_child(&sprite);
+	TEST_CASE(root.get_node(body_path) == nullptr);
+	enemy.add_child(&body);
+	TEST_CASE(root.get_node(body_path) == &body);
+
+	enemy.remove_child(&body);
+	root.remove_child(&bullet);
+	enemies.remove_child(&enemy);
+	TEST_CASE(enemies.find_child("Enemy") == nullptr);
+	TEST_CASE(root.get_node(body_path) == nullptr);
+
+	return true;
+}
+
+bool NodeGroupTest::_test() {
+	detail::NodeGroup group("Enemies");
+	Node first, second, third;
+
+	group.add(&first);
+	group.add(&second);
+	group.add(&third);
+	TEST_CASE(group.get_nodes().size() == 3);
+
+	// The last node is moved in the place of the removed node.
+	group.remove(&first, 0);
+	TEST_CASE(group.get_nodes().size() == 2 && group.get_nodes()[0] == &third);
+
+	group.remove(&third, 0);
+	TEST_CASE(group.get_nodes().size() == 1 && group.get_nodes()[0] == &second);
+
+	// Removing a node while iterating leaves a hole, which is removed once the iteration ends.
+	natural calls = 0;
+	group.add(&first);
+	natural count_after_removal = 0;
+	group.for_each([&group, &calls, &first, &count_after_removal](Node *node) {
+		calls++;
+		if (node != &first) {
+			group.remove(&first, 1);
+			count_after_removal = group.get_node_count();
+		}
+	});
+	TEST_CASE(calls == 1 && count_after_removal == 1);
+	TEST_CASE(group.get_nodes().size() == 1 && group.get_nodes()[0] == &second);
+
+	return true;
+}
+
+
+bool PackedSceneTest::_test() {
+	Node level;
+	Node2D player;
+	CanvasNode hud;
+	level.set_name("Level");
+	player.set_name("Player");
+	player.set_position(Vector2f(4, 8));
+	player.add_to_group("Players");
+	hud.set_name("Hud");
+	hud.set_zindex(3);
+	hud.hide();
+
+	level.add_child(&player);
+	player.add_child(&hud);
+
+	PackedScene packed_scene;
+	TEST_CASE(packed_scene.pack(&level));
+	TEST_CASE(packed_scene.get_node_count() == 3);
+
+	// Saved and loaded again, like a scene stored in a file.
+	std::stringstream stream = std::stringstream(std::ios::in | std::ios::out | std::ios::binary);
+	{
+		cereal::PortableBinaryOutputArchive archive(stream);
+		archive(packed_scene);
+	}
+
+	PackedScene loaded_scene;
+	{
+		cereal::PortableBinaryInputArchive archive(stream);
+		archive(loaded_scene);
+	}
+
+	Node *instance = loaded_scene.instantiate();
+	TEST_CASE(instance && instance->get_name() == "Level" && instance->get_child_count() == 1);
+
+	Node2D *instanced_player = dynamic_cast<Node2D*>(instance->get_node("Player"));
+	TEST_CASE(instanced_player && instanced_player->get_position() == Vector2f(4, 8));
+	TEST_CASE(instanced_player->is_in_group("Players"));
+
+	CanvasNode *instanced_hud = dynamic_cast<CanvasNode*>(instance->get_node("Player/Hud"));
+	TEST_CASE(instanced_hud && !instanced_hud->is_visible() && instanced_hud->get_zindex() == 3);
+
+	delete instanced_hud;
+	delete instanced_player;
+	delete instance;
+
+	PackedScene empty_scene;
+	TEST_CASE(empty_scene.instantiate() == nullptr);
+
+	// Instancing under a parent inside the tree takes the batched path.
+	Node2D ship;
+	Sprite2D hull, turret;
+	ship.set_name("Ship");
+	ship.add_to_group("Ships");
+	ship.set_process_input(true);
+	hull.set_name("Hull");
+	turret.set_name("Turret");
+	hull.set_texture(std::make_shared<Toof::FileTexture>(nullptr, "ship.png"));
+	turret.set_texture(std::make_shared<Toof::FileTexture>(nullptr, "ship.png"));
+	ship.add_child(&hull);
+	ship.add_child(&turret);
+	TEST_CASE(packed_scene.pack(&ship));
+
+	SceneTree tree = SceneTree(true);
+	Node spawner, last;
+	tree.get_root()->add_child(&spawner);
+	tree.get_root()->add_child(&last);
+
+	Node *ship_instance = packed_scene.instantiate(&spawner);
+	TEST_CASE(ship_instance && ship_instance->get_parent() == &spawner && ship_instance->is_inside_tree());
+	TEST_CASE(tree.get_group_node_count("Ships") == 1);
+
+	Sprite2D *instanced_hull = dynamic_cast<Sprite2D*>(ship_instance->get_node("Hull"));
+	Sprite2D *instanced_turret = dynamic_cast<Sprite2D*>(ship_instance->get_node("Turret"));
+	TEST_CASE(instanced_hull && instanced_hull->is_inside_tree() && instanced_turret && instanced_turret->is_inside_tree());
+
+	// Sprites using the same file share one texture, so it is only loaded once.
+	TEST_CASE(instanced_hull->get_texture() && instanced_hull->get_texture() == instanced_turret->get_texture());
+
+	// The instance comes before the nodes after its parent once the tree order is updated.
+	tree.step(1, 0.1);
+	TEST_CASE(instanced_turret->get_tree_order() < last.get_tree_order());
+
+	spawner.remove_child(ship_instance);
+	TEST_CASE(tree.get_group_node_count("Ships") == 0);
+	delete instanced_turret;
+	delete instanced_hull;
+	delete ship_instance;
+
+	tree.get_root()->remove_child(&spawner);
+	tree.get_root()->remove_child(&last);
+	ship.remove_child(&hull);
+	ship.remove_child(&turret);
+	return true;
+}
+
+
+class ProcessCounter : public Node {
+	void _process(const double delta) override {
+		process_count++;
+		processed_time += delta;
+	}
+
+	void _physics_process(const double delta) override {
+		physics_process_count++;
+		physics_processed_time += delta;
+	}
+public:
+	Toof::natural process_count = 0;
+	double processed_time = 0.0;
+	Toof::natural physics_process_count = 0;
+	double physics_processed_time = 0.0;
+};
+
+bool SceneTreeTest::_test() {
+	SceneTree tree = SceneTree(true);
+	TEST_CASE(tree.is_headless() && !tree.get_rendering_server() && !tree.get_window());
+
+	ProcessCounter counter;
+	Node2D node2d;
+	counter.set_process(true);
+	tree.get_root()->add_child(&counter);
+	tree.get_root()->add_child(&node2d);
+
+	// CanvasNodes don't get a canvas item without a RenderingServer.
+	node2d.set_position(Vector2f(1, 1));
+	TEST_CASE(node2d.get_canvas_item() == 0);
+
+	tree.step(120, 0.5);
+	TEST_CASE(counter.process_count == 120 && counter.processed_time == 60.0);
+	TEST_CASE(tree.get_process_loop().get_step_count() == 120);
+
+	tree.get_process_loop().pause();
+	tree.step(10, 0.5);
+	TEST_CASE(counter.process_count == 120);
+
+	tree.get_root()->remove_child(&counter);
+	tree.get_root()->remove_child(&node2d);
+	return true;
+}
+
+
+bool LoopPacingTest::_test() {
+	SceneTree tree = SceneTree(true);
+	ProcessCounter counter;
+	counter.set_process(true);
+	tree.get_root()->add_child(&counter);
+
+	SceneTree::Loop &process_loop = tree.get_process_loop();
+	const long step_time = static_cast<long>(process_loop.get_step_time() * std::nano::den);
+	const long start = process_loop.get_next_step_time();
+
+	tree.step_loops(start);
+	TEST_CASE(counter.process_count == 1 && process_loop.get_next_step_time() == start + step_time);
+	TEST_CASE(process_loop.get_missed_deadlines() == 0 && process_loop.get_max_overshoot() == 0.0);
+
+	// Waking up early doesn't step the loop.
+	tree.step_loops(start + step_time - 1000000);
+	TEST_CASE(counter.process_count == 1);
+
+	// A late step advances the deadline from the previous deadline, so the next step is on time again.
+	tree.step_loops(start + step_time + 2000000);
+	TEST_CASE(counter.process_count == 2 && process_loop.get_next_step_time() == start + 2 * step_time);
+	TEST_CASE(Toof::Math::is_equal_approx(process_loop.get_last_overshoot(), 0.002) && process_loop.get_missed_deadlines() == 0);
+	TEST_CASE(Toof::Math::is_equal_approx(process_loop.get_max_overshoot(), 0.002) && process_loop.get_jitter() > 0.0);
+
+	// Missing a whole step runs one step and continues from now, instead of running the missed steps in a burst.
+	const long late_time = start + 2 * step_time + 7 * step_time / 2;
+	tree.step_loops(late_time);
+	TEST_CASE(counter.process_count == 3 && process_loop.get_missed_deadlines() == 1);
+	TEST_CASE(process_loop.get_next_step_time() == late_time + step_time);
+	TEST_CASE(Toof::Math::is_equal_approx(process_loop.get_max_overshoot(), static_cast<double>(7 * step_time / 2) / std::nano::den));
+
+	tree.step_loops(late_time + step_time - 1);
+	TEST_CASE(counter.process_count == 3);
+	tree.step_loops(late_time + step_time);
+	TEST_CASE(counter.process_count == 4 && process_loop.get_missed_deadlines() == 1);
+
+	process_loop.reset_pacing_stats();
+	TEST_CASE(process_loop.get_missed_deadlines() == 0 && process_loop.get_max_overshoot() == 0.0 && process_loop.get_jitter() == 0.0);
+
+	tree.get_root()->remove_child(&counter);
+	return true;
+}
+
+bool PhysicsStepTest::_test() {
+	#ifdef TOOF_PHYSICS_ENABLED
+	SceneTree tree = SceneTree(true);
+	ProcessCounter counter;
+	counter.set_physics_process(true);
+	tree.get_root()->add_child(&counter);
+	tree.set_max_physics_substeps(4);
+
+	const double physics_step_time = tree.get_physics_loop().get_step_time();
+
+	// The physics steps that fit in a step run, the rest is simulated by a later step.
+	tree.step(1, physics_step_time * 2.5);
+	TEST_CASE(counter.physics_process_count == 2);
+	TEST_CASE(Toof::Math::is_equal_approx(tree.get_physics_time_accumulator(), physics_step_time * 0.5));
+	TEST_CASE(Toof::Math::is_equal_approx(tree.get_physics_interpolation_fraction(), 0.5));
+
+	// A long step runs at most the maximum amount of substeps, the whole physics steps left after them are dropped.
+	tree.step(1, physics_step_time * 10.25);
+	TEST_CASE(counter.physics_process_count == 6 && tree.get_physics_loop().get_step_count() == 2);
+	TEST_CASE(Toof::Math::is_equal_approx(counter.physics_processed_time, physics_step_time * 6.0));
+	TEST_CASE(Toof::Math::is_equal_approx(tree.get_physics_time_accumulator(), physics_step_time * 0.75));
+	TEST_CASE(Toof::Math::is_equal_approx(tree.get_physics_interpolation_fraction(), 0.75));
+
+	// Raising the limit catches up instead.
+	tree.set_max_physics_substeps(16);
+	tree.step(1, physics_step_time * 10.25);
+	TEST_CASE(counter.physics_process_count == 17 && Toof::Math::is_equal_approx(tree.get_physics_interpolation_fraction(), 0.0));
+
+	tree.get_root()->remove_child(&counter);
+	#endif
+	return true;
+}
+
+class SlowProcessNode : public Node {
+	void _process(const double) override {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+};
+
+bool NodeTimingTest::_test() {
+	SceneTree tree = SceneTree(true);
+	ProcessCounter counter;
+	counter.set_process(true);
+	tree.get_root()->add_child(&counter);
+
+	// Nothing is measured until node timing is enabled.
+	tree.step(1, 0.1);
+	TEST_CASE(tree.get_node_timing(&counter, Node::NOTIFICATION_PROCESS).maximum == 0.0);
+
+	int exceeded_what = 0;
+	std::vector<Toof::NodeTimeReport> offenders;
+	tree.node_time_budget_exceeded.connect([&exceeded_what, &offenders](const int what, const std::vector<Toof::NodeTimeReport> &reports) {
+		exceeded_what = what;
+		offenders = reports;
+	});
+
+	tree.set_node_timing_enabled(true);
+	tree.set_node_time_budget(1e-12);
+	tree.step(3, 0.1);
+
+	TEST_CASE(tree.get_node_timing(&counter, Node::NOTIFICATION_PROCESS).average > 0.0);
+	TEST_CASE(tree.get_type_timing<ProcessCounter>(Node::NOTIFICATION_PROCESS).maximum > 0.0);
+	TEST_CASE(tree.get_type_timing<ProcessCounter>(Node::NOTIFICATION_RENDER).maximum == 0.0);
+	TEST_CASE(exceeded_what == Node::NOTIFICATION_PROCESS);
+	TEST_CASE(offenders.size() == 1 && offenders[0].node == &counter);
+	tree.get_root()->remove_child(&counter);
+
+	// The budget is for all steps of a frame together, each process step alone stays under it.
+	SlowProcessNode slow_node;
+	slow_node.set_process(true);
+	tree.get_root()->add_child(&slow_node);
+	tree.set_node_time_budget(0.003);
+	exceeded_what = 0;
+	offenders.clear();
+
+	tree.step_process(0.1);
+	tree.step_process(0.1);
+	TEST_CASE(offenders.empty());
+	tree.step_render(0.1);
+	TEST_CASE(exceeded_what == Node::NOTIFICATION_PROCESS);
+	TEST_CASE(offenders.size() == 1 && offenders[0].node == &slow_node && offenders[0].time >= 0.004);
+
+	// While the render loop is paused, every process step of the main loop is a frame, so the time doesn't pile up until the next render.
+	tree.get_render_loop().pause();
+	tree.set_node_time_budget(0.005);
+	offenders.clear();
+
+	const uint64_t step_count = tree.get_process_loop().get_step_count();
+	for (int i = 0; i < 3; i++)
+		tree.step_loops(tree.get_process_loop().get_next_step_time());
+	TEST_CASE(tree.get_process_loop().get_step_count() == step_count + 3 && offenders.empty());
+
+	tree.get_render_loop().unpause();
+	tree.step_render(0.1);
+	TEST_CASE(offenders.empty());
+
+	tree.get_root()->remove_child(&slow_node);
+	return true;
+}
+
+class ThreadGroupNode : public Node {
+	void _process(const double) override {
+		process_count++;
+
+		// Deferred calls of a thread group run on the main thread, in order of the group.
+		call_deferred([this]() {
+			deferred_order.push_back(get_process_thread_group());
+		});
+
+		// Renaming changes the name index of the parent, so it is deferred to the main thread.
+		if (process_count == 1)
+			call_deferred([this]() {
+				set_name("Group" + std::to_string(get_process_thread_group()));
+			});
+
+		if (process_count == 2 && freed_node)
+			freed_node->queue_free();
+	}
+public:
+	std::vector<Toof::natural> &deferred_order;
+	Node *freed_node = nullptr;
+	Toof::natural process_count = 0;
+
+	ThreadGroupNode(std::vector<Toof::natural> &deferred_order): deferred_order(deferred_order) {
+	}
+};
+
+class DeletionFlag : public Node {
+public:
+	bool &deleted;
+
+	DeletionFlag(bool &deleted): deleted(deleted) {
+	}
+
+	~DeletionFlag() {
+		deleted = true;
+	}
+};
+
+bool ThreadGroupTest::_test() {
+	SceneTree tree = SceneTree(true);
+	std::vector<Toof::natural> deferred_order;
+	std::vector<std::unique_ptr<ThreadGroupNode>> nodes;
+	bool deleted = false;
+	DeletionFlag *freed_node = new DeletionFlag(deleted);
+
+	for (Toof::natural thread_group: {3, 1, 0, 2}) {
+		nodes.push_back(std::make_unique<ThreadGroupNode>(deferred_order));
+		nodes.back()->set_process_thread_group(thread_group);
+		nodes.back()->set_process(true);
+		tree.get_root()->add_child(nodes.back().get());
+	}
+
+	// A node in a thread group frees a node of the same group from a worker thread.
+	freed_node->set_process_thread_group(1);
+	nodes[1]->freed_node = freed_node;
+	tree.get_root()->add_child(freed_node);
+
+	tree.step(1, 0.1);
+	TEST_CASE(deferred_order == std::vector<Toof::natural>({1, 2, 3, 0}));
+	TEST_CASE(!deleted);
+	TEST_CASE(tree.get_root()->find_child("Group3") == nodes[0].get() && tree.get_root()->find_child("Group0") == nodes[2].get());
+
+	tree.step(4, 0.1);
+	TEST_CASE(deleted);
+	for (const std::unique_ptr<ThreadGroupNode> &node: nodes)
+		TEST_CASE(node->process_count == 5);
+
+	for (const std::unique_ptr<ThreadGroupNode> &node: nodes)
+		tree.get_root()->remove_child(node.get());
+	return true;
+}
+
+class InputHandler : public Node {
+	void _event(const Toof::InputEventRef) override {
+		received_order.push_back(this);
+		if (handles_input)
+			get_tree()->set_input_as_handled();
+	}
+public:
+	std::vector<Node*> &received_order;
+	bool handles_input = false;
+
+	InputHandler(std::vector<Node*> &received_order): received_order(received_order) {
+	}
+};
+
+bool InputPropagationTest::_test() {
+	SceneTree tree = SceneTree(true);
+	std::vector<Node*> received_order;
+	InputHandler first(received_order), second(received_order), child(received_order);
+	Node ignored;
+
+	first.add_child(&child);
+	tree.get_root()->add_child(&first);
+	tree.get_root()->add_child(&ignored);
+	tree.get_root()->add_child(&second);
+	first.set_process_input(true);
+	second.set_process_input(true);
+	child.set_process_input(true);
+
+	// Handlers are called in reverse tree order.
+	const Toof::InputEventKeyboard keyboard_event;
+	const Toof::InputEventRef input_event = &keyboard_event;
+	tree.push_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&second, &child, &first}));
+
+	received_order.clear();
+	child.handles_input = true;
+	tree.push_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&second, &child}));
+	TEST_CASE(tree.is_input_handled());
+
+	received_order.clear();
+	tree.get_root()->propagate_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&second, &child}));
+
+	received_order.clear();
+	second.set_process_input(false);
+	child.handles_input = false;
+	tree.push_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&child, &first}));
+
+	// The order follows the position in the tree, not the order the nodes entered the tree in.
+	InputHandler late_child(received_order);
+	late_child.set_process_input(true);
+	second.set_process_input(true);
+	first.add_child(&late_child);
+	TEST_CASE(late_child.get_tree_order() > second.get_tree_order());
+
+	received_order.clear();
+	tree.push_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&second, &late_child, &child, &first}));
+	TEST_CASE(late_child.get_tree_order() < second.get_tree_order());
+
+	received_order.clear();
+	tree.get_root()->move_child(&second, 0);
+	tree.push_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&late_child, &child, &first, &second}));
+
+	received_order.clear();
+	tree.get_root()->propagate_input_event(input_event);
+	TEST_CASE(received_order == std::vector<Node*>({&late_child, &child, &first, &second}));
+
+	first.remove_child(&late_child);
+	first.remove_child(&child);
+	tree.get_root()->remove_child(&first);
+	tree.get_root()->remove_child(&ignored);
+	tree.get_root()->remove_child(&second);
+	return true;
+}
@@ -29,7 +29,10 @@
   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
+#include <tests/core_tests.hpp>
+#include <tests/input_tests.hpp>
 #include <tests/math_tests.hpp>
+#include <tests/scene_tests.hpp>
 #include <core/utility_functions.hpp>
 
 #include <unordered_map>
@@ -46,6 +49,25 @@ void create_tests() {
 	tests.insert({"fail", std::make_unique<FailTest>()});
 	tests.insert({"math", std::make_unique<MathTest>()});
 	tests.insert({"color", std::make_unique<ColorTest>()});
+	tests.insert({"thread_pool", std::make_unique<ThreadPoolTest>()});
+	tests.insert({"call_queue", std::make_unique<CallQueueTest>()});
+	tests.insert({"profiler", std::make_unique<ProfilerTest>()});
+	tests.insert({"dynamic_resolution", std::make_unique<DynamicResolutionTest>()});
+	tests.insert({"node", std::make_unique<NodeTest>()});
+	tests.insert({"node_pool", std::make_unique<NodePoolTest>()});
+	tests.insert({"node_path", std::make_unique<NodePathTest>()});
+	tests.insert({"node_group", std::make_unique<NodeGroupTest>()});
+	tests.insert({"packed_scene", std::make_unique<PackedSceneTest>()});
+	tests.insert({"scene_tree", std::make_unique<SceneTreeTest>()});
+	tests.insert({"loop_pacing", std::make_unique<LoopPacingTest>()});
+	tests.insert({"physics_step", std::make_unique<PhysicsStepTest>()});
+	tests.insert({"node_timing", std::make_unique<NodeTimingTest>()});
+	tests.insert({"thread_group", std::make_unique<ThreadGroupTest>()});
+	tests.insert({"input_propagation", std::make_unique<InputPropagationTest>()});
+	tests.insert({"input_map", std::make_unique<InputMapTest>()});
+	tests.insert({"input", std::make_unique<InputTest>()});
+	tests.insert({"input_recording", std::make_unique<InputRecordingTest>()});
+	tests.insert({"input_coalescing", std::make_unique<InputCoalescingTest>()});
 }
 
 constexpr bool str_same(const char *str1, const char *str2) {